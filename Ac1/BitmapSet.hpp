@@ -0,0 +1,536 @@
+#ifndef BITMAPSET_HPP
+#define BITMAPSET_HPP
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <cstdint>
+#include <cstddef>
+#ifdef __SSE2__
+#include <immintrin.h>
+#endif
+
+// Operacoes sobre vetores de palavras de 64 bits usadas pelo BitmapSet. Com
+// AVX2 cada instrucao combina 4 palavras, com SSE2 2; sem elas o laco
+// escalar eh usado.
+namespace bitmap_simd {
+
+    // Os lacos vetoriais param em blocks, o maior multiplo do tamanho do bloco
+    // que cabe em n; com a condicao i + 4 <= n o GCC nao limitava o laco
+    // escalar que segue e avisava (-Waggressive-loop-optimizations).
+
+    // out[i] = a[i] | b[i]
+    inline void or_words(uint64_t* out, const uint64_t* a, const uint64_t* b, size_t n){
+        size_t i = 0;
+#if defined(__AVX2__)
+        for(size_t blocks = n - n % 4; i < blocks; i += 4){
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_or_si256(x, y));
+        }
+#elif defined(__SSE2__)
+        for(size_t blocks = n - n % 2; i < blocks; i += 2){
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_or_si128(x, y));
+        }
+#endif
+        for(; i < n; i++){
+            out[i] = a[i] | b[i];
+        }
+    }
+
+    // out[i] = a[i] & b[i]
+    inline void and_words(uint64_t* out, const uint64_t* a, const uint64_t* b, size_t n){
+        size_t i = 0;
+#if defined(__AVX2__)
+        for(size_t blocks = n - n % 4; i < blocks; i += 4){
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_and_si256(x, y));
+        }
+#elif defined(__SSE2__)
+        for(size_t blocks = n - n % 2; i < blocks; i += 2){
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_and_si128(x, y));
+        }
+#endif
+        for(; i < n; i++){
+            out[i] = a[i] & b[i];
+        }
+    }
+
+    // out[i] = a[i] & ~b[i]
+    inline void andnot_words(uint64_t* out, const uint64_t* a, const uint64_t* b, size_t n){
+        size_t i = 0;
+#if defined(__AVX2__)
+        for(size_t blocks = n - n % 4; i < blocks; i += 4){
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_andnot_si256(y, x));
+        }
+#elif defined(__SSE2__)
+        for(size_t blocks = n - n % 2; i < blocks; i += 2){
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_andnot_si128(y, x));
+        }
+#endif
+        for(; i < n; i++){
+            out[i] = a[i] & ~b[i];
+        }
+    }
+
+    // numero de bits ligados em words[0, n)
+    inline size_t popcount(const uint64_t* words, size_t n){
+        size_t total = 0;
+        for(size_t i = 0; i < n; i++){
+            total += __builtin_popcountll(words[i]);
+        }
+        return total;
+    }
+}
+
+// Conjunto de int comprimido no estilo Roaring, com a mesma interface (e as
+// mesmas mensagens) do Set.
+//
+// Cada chave eh levada para 32 bits sem sinal preservando a ordem (o bit de
+// sinal eh invertido). Os 16 bits altos escolhem um container e os 16 baixos
+// sao guardados nele. Um container com ate ARRAY_MAX elementos eh um vetor
+// ordenado de uint16_t (2 bytes por elemento); acima disso vira um bitmap de
+// 2^16 bits (8 KB), que custa menos de 2 bytes por elemento. Intervalos densos
+// de ids ocupam entao ~1 bit por elemento. Uniao, intersecao e diferenca de
+// dois bitmaps sao OR/AND/ANDNOT de palavras de 64 bits (bitmap_simd).
+class BitmapSet{
+    public:
+    // maior container guardado como vetor
+    static constexpr size_t ARRAY_MAX = 4096;
+
+    // palavras de 64 bits de um container bitmap
+    static constexpr size_t WORDS = 1024;
+
+    BitmapSet(){
+    }
+
+    void Insert(int k){
+        uint32_t u = _encode(k);
+        size_t c = _find(u >> 16);
+        if(c == _containers.size() || _containers[c].key != (u >> 16)){
+            Container fresh;
+            fresh.key = static_cast<uint16_t>(u >> 16);
+            _containers.insert(_containers.begin() + c, fresh);
+        }
+        Container& box = _containers[c];
+        uint16_t low = static_cast<uint16_t>(u);
+        if(box.bitmap()){
+            uint64_t mask = uint64_t(1) << (low % 64);
+            if(!(box.bits[low / 64] & mask)){
+                box.bits[low / 64] |= mask;
+                box.size++;
+            }
+            return;
+        }
+        auto it = std::lower_bound(box.array.begin(), box.array.end(), low);
+        if(it == box.array.end() || *it != low){
+            box.array.insert(it, low);
+            box.size++;
+            if(box.size > ARRAY_MAX){
+                _toBitmap(box);
+            }
+        }
+    }
+
+    void Clear(){
+        _containers.clear();
+    }
+
+    void Erase(int k){
+        uint32_t u = _encode(k);
+        size_t c = _find(u >> 16);
+        if(c == _containers.size() || _containers[c].key != (u >> 16)){
+            return;
+        }
+        Container& box = _containers[c];
+        uint16_t low = static_cast<uint16_t>(u);
+        if(box.bitmap()){
+            uint64_t mask = uint64_t(1) << (low % 64);
+            if(box.bits[low / 64] & mask){
+                box.bits[low / 64] &= ~mask;
+                box.size--;
+                if(box.size <= ARRAY_MAX){
+                    _toArray(box);
+                }
+            }
+        }else{
+            auto it = std::lower_bound(box.array.begin(), box.array.end(), low);
+            if(it != box.array.end() && *it == low){
+                box.array.erase(it);
+                box.size--;
+            }
+        }
+        if(box.size == 0){
+            _containers.erase(_containers.begin() + c);
+        }
+    }
+
+    bool Contains(int k) const {
+        uint32_t u = _encode(k);
+        size_t c = _find(u >> 16);
+        if(c == _containers.size() || _containers[c].key != (u >> 16)){
+            return false;
+        }
+        return _containers[c].contains(static_cast<uint16_t>(u));
+    }
+
+    bool Empty() const {
+        return _containers.empty();
+    }
+
+    int Size() const {
+        size_t total = 0;
+        for(const Container& box : _containers){
+            total += box.size;
+        }
+        return static_cast<int>(total);
+    }
+
+    int Minimum() const {
+        if(Empty()){
+            throw std::runtime_error("The provided set is empty.");
+        }
+        const Container& box = _containers.front();
+        return _decode(box.key, box.next(0));
+    }
+
+    int Maximum() const {
+        if(Empty()){
+            throw std::runtime_error("The provided set is empty.");
+        }
+        const Container& box = _containers.back();
+        return _decode(box.key, box.previous(UINT16_MAX));
+    }
+
+    int Successor(int x) const {
+        if(!Contains(x)){
+            throw std::runtime_error("The set does not contains this element.");
+        }
+        uint32_t u = _encode(x);
+        size_t c = _find(u >> 16);
+        uint16_t low = static_cast<uint16_t>(u);
+        int found;
+        if(low < UINT16_MAX && (found = _containers[c].next(low + 1)) >= 0){
+            std::cout << "the successor is: ";
+            return _decode(_containers[c].key, found);
+        }
+        if(c + 1 == _containers.size()){
+            throw std::runtime_error("The element does not have a Successor in the set.");
+        }
+        std::cout << "the successor is: ";
+        return _decode(_containers[c + 1].key, _containers[c + 1].next(0));
+    }
+
+    int Predecessor(int x) const {
+        if(!Contains(x)){
+            throw std::runtime_error("The set does not contains this element.");
+        }
+        uint32_t u = _encode(x);
+        size_t c = _find(u >> 16);
+        uint16_t low = static_cast<uint16_t>(u);
+        int found;
+        if(low > 0 && (found = _containers[c].previous(low - 1)) >= 0){
+            std::cout << "the predecessor is: ";
+            return _decode(_containers[c].key, found);
+        }
+        if(c == 0){
+            throw std::runtime_error("The element does not have a Predecessor in the set.");
+        }
+        std::cout << "the predecessor is: ";
+        return _decode(_containers[c - 1].key, _containers[c - 1].previous(UINT16_MAX));
+    }
+
+    void Swap(BitmapSet* x){
+        _containers.swap(x->_containers);
+    }
+
+    void Union(BitmapSet* x, BitmapSet* y){
+        BitmapSet result;
+        _unite(x->_containers, y->_containers, result._containers);
+        _keep(result);
+        Show();
+    }
+
+    void Intersection(BitmapSet* x, BitmapSet* y){
+        BitmapSet result;
+        size_t i = 0, j = 0;
+        while(i < x->_containers.size() && j < y->_containers.size()){
+            const Container& a = x->_containers[i];
+            const Container& b = y->_containers[j];
+            if(a.key < b.key){
+                i++;
+            }else if(b.key < a.key){
+                j++;
+            }else{
+                Container box = _intersect(a, b);
+                if(box.size > 0){
+                    result._containers.push_back(std::move(box));
+                }
+                i++;
+                j++;
+            }
+        }
+        _keep(result);
+        Show();
+    }
+
+    void Difference(BitmapSet* x, BitmapSet* y){
+        BitmapSet result;
+        size_t j = 0;
+        for(const Container& a : x->_containers){
+            while(j < y->_containers.size() && y->_containers[j].key < a.key){
+                j++;
+            }
+            if(j < y->_containers.size() && y->_containers[j].key == a.key){
+                Container box = _subtract(a, y->_containers[j]);
+                if(box.size > 0){
+                    result._containers.push_back(std::move(box));
+                }
+            }else{
+                result._containers.push_back(a);
+            }
+        }
+        _keep(result);
+        Show();
+    }
+
+    void Show() const {
+        for(const Container& box : _containers){
+            for(int low = box.next(0); low >= 0; low = low < UINT16_MAX ? box.next(low + 1) : -1){
+                std::cout << _decode(box.key, low) << " ";
+            }
+        }
+    }
+
+    // substitui o conteudo pelo de x (nullptr esvazia o conjunto)
+    void operator=(BitmapSet* x){
+        if(x == nullptr){
+            Clear();
+        }else if(x != this){
+            _containers = x->_containers;
+        }
+    }
+
+    private:
+    // elementos com os mesmos 16 bits altos
+    struct Container {
+        uint16_t key;                 // 16 bits altos
+        size_t size = 0;              // numero de elementos
+        std::vector<uint16_t> array;  // 16 bits baixos em ordem (container vetor)
+        std::vector<uint64_t> bits;   // WORDS palavras (container bitmap)
+
+        bool bitmap() const {
+            return !bits.empty();
+        }
+
+        bool contains(uint16_t low) const {
+            if(bitmap()){
+                return (bits[low / 64] >> (low % 64)) & 1;
+            }
+            return std::binary_search(array.begin(), array.end(), low);
+        }
+
+        // menor elemento >= from, ou -1
+        int next(uint32_t from) const {
+            if(!bitmap()){
+                auto it = std::lower_bound(array.begin(), array.end(), from);
+                return it == array.end() ? -1 : *it;
+            }
+            size_t w = from / 64;
+            uint64_t word = bits[w] & (~uint64_t(0) << (from % 64));
+            while(word == 0){
+                if(++w == WORDS){
+                    return -1;
+                }
+                word = bits[w];
+            }
+            return static_cast<int>(w * 64 + __builtin_ctzll(word));
+        }
+
+        // maior elemento <= from, ou -1
+        int previous(uint32_t from) const {
+            if(!bitmap()){
+                auto it = std::upper_bound(array.begin(), array.end(), from);
+                return it == array.begin() ? -1 : *(it - 1);
+            }
+            size_t w = from / 64;
+            uint64_t word = bits[w] & (~uint64_t(0) >> (63 - from % 64));
+            while(word == 0){
+                if(w-- == 0){
+                    return -1;
+                }
+                word = bits[w];
+            }
+            return static_cast<int>(w * 64 + 63 - __builtin_clzll(word));
+        }
+    };
+
+    std::vector<Container> _containers; // em ordem crescente de key
+
+    // int -> uint32_t preservando a ordem
+    static uint32_t _encode(int k){
+        return static_cast<uint32_t>(k) ^ 0x80000000u;
+    }
+
+    static int _decode(uint16_t key, int low){
+        return static_cast<int>(((uint32_t(key) << 16) | uint32_t(low)) ^ 0x80000000u);
+    }
+
+    // posicao do primeiro container com key >= high
+    size_t _find(uint32_t high) const {
+        size_t lo = 0, hi = _containers.size();
+        while(lo < hi){
+            size_t mid = (lo + hi) / 2;
+            if(_containers[mid].key < high){
+                lo = mid + 1;
+            }else{
+                hi = mid;
+            }
+        }
+        return lo;
+    }
+
+    static void _toBitmap(Container& box){
+        box.bits.assign(WORDS, 0);
+        for(uint16_t low : box.array){
+            box.bits[low / 64] |= uint64_t(1) << (low % 64);
+        }
+        std::vector<uint16_t>().swap(box.array);
+    }
+
+    static void _toArray(Container& box){
+        box.array.clear();
+        box.array.reserve(box.size);
+        for(size_t w = 0; w < WORDS; w++){
+            for(uint64_t word = box.bits[w]; word != 0; word &= word - 1){
+                box.array.push_back(static_cast<uint16_t>(w * 64 + __builtin_ctzll(word)));
+            }
+        }
+        std::vector<uint64_t>().swap(box.bits);
+    }
+
+    // escolhe a representacao pelo tamanho
+    static void _normalize(Container& box){
+        if(box.bitmap() && box.size <= ARRAY_MAX){
+            _toArray(box);
+        }else if(!box.bitmap() && box.size > ARRAY_MAX){
+            _toBitmap(box);
+        }
+    }
+
+    static Container _merge(const Container& a, const Container& b){
+        Container box;
+        box.key = a.key;
+        if(a.bitmap() && b.bitmap()){
+            box.bits.resize(WORDS);
+            bitmap_simd::or_words(box.bits.data(), a.bits.data(), b.bits.data(), WORDS);
+            box.size = bitmap_simd::popcount(box.bits.data(), WORDS);
+        }else if(a.bitmap() || b.bitmap()){
+            const Container& dense = a.bitmap() ? a : b;
+            const Container& sparse = a.bitmap() ? b : a;
+            box.bits = dense.bits;
+            box.size = dense.size;
+            for(uint16_t low : sparse.array){
+                uint64_t mask = uint64_t(1) << (low % 64);
+                box.size += (box.bits[low / 64] & mask) ? 0 : 1;
+                box.bits[low / 64] |= mask;
+            }
+        }else{
+            std::set_union(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                           std::back_inserter(box.array));
+            box.size = box.array.size();
+            _normalize(box);
+        }
+        return box;
+    }
+
+    static Container _intersect(const Container& a, const Container& b){
+        Container box;
+        box.key = a.key;
+        if(a.bitmap() && b.bitmap()){
+            box.bits.resize(WORDS);
+            bitmap_simd::and_words(box.bits.data(), a.bits.data(), b.bits.data(), WORDS);
+            box.size = bitmap_simd::popcount(box.bits.data(), WORDS);
+            _normalize(box);
+        }else if(a.bitmap() || b.bitmap()){
+            const Container& dense = a.bitmap() ? a : b;
+            const Container& sparse = a.bitmap() ? b : a;
+            for(uint16_t low : sparse.array){
+                if(dense.contains(low)){
+                    box.array.push_back(low);
+                }
+            }
+            box.size = box.array.size();
+        }else{
+            std::set_intersection(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                                  std::back_inserter(box.array));
+            box.size = box.array.size();
+        }
+        return box;
+    }
+
+    static Container _subtract(const Container& a, const Container& b){
+        Container box;
+        box.key = a.key;
+        if(a.bitmap() && b.bitmap()){
+            box.bits.resize(WORDS);
+            bitmap_simd::andnot_words(box.bits.data(), a.bits.data(), b.bits.data(), WORDS);
+            box.size = bitmap_simd::popcount(box.bits.data(), WORDS);
+            _normalize(box);
+        }else if(a.bitmap()){
+            box.bits = a.bits;
+            box.size = a.size;
+            for(uint16_t low : b.array){
+                uint64_t mask = uint64_t(1) << (low % 64);
+                box.size -= (box.bits[low / 64] & mask) ? 1 : 0;
+                box.bits[low / 64] &= ~mask;
+            }
+            _normalize(box);
+        }else{
+            for(uint16_t low : a.array){
+                if(!b.contains(low)){
+                    box.array.push_back(low);
+                }
+            }
+            box.size = box.array.size();
+        }
+        return box;
+    }
+
+    // uniao das listas de containers a e b em out
+    static void _unite(const std::vector<Container>& a, const std::vector<Container>& b, std::vector<Container>& out){
+        size_t i = 0, j = 0;
+        while(i < a.size() || j < b.size()){
+            if(j == b.size() || (i < a.size() && a[i].key < b[j].key)){
+                out.push_back(a[i++]);
+            }else if(i == a.size() || b[j].key < a[i].key){
+                out.push_back(b[j++]);
+            }else{
+                out.push_back(_merge(a[i++], b[j++]));
+            }
+        }
+    }
+
+    // une result aos elementos que o conjunto ja tem (como o Set, as
+    // operacoes acrescentam o resultado ao conjunto)
+    void _keep(BitmapSet& result){
+        if(!_containers.empty()){
+            std::vector<Container> merged;
+            _unite(_containers, result._containers, merged);
+            result._containers.swap(merged);
+        }
+        _containers.swap(result._containers);
+    }
+};
+
+#endif
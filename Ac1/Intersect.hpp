@@ -0,0 +1,168 @@
+#ifndef INTERSECT_HPP
+#define INTERSECT_HPP
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#ifdef __SSE2__
+#include <immintrin.h>
+#endif
+
+// Intersecao de sequencias ordenadas de int sem repeticoes (como as que
+// Set::Export e VectorSet::Export devolvem).
+//
+// intersect() escolhe a estrategia pelos tamanhos:
+//  - se uma sequencia eh pelo menos SKEW vezes maior, cada elemento da
+//    menor eh procurado na maior com busca exponencial (galloping) a partir
+//    da posicao do ultimo encontrado: O(m log(n/m));
+//  - senao, com AVX2 ou SSE2, blocos de 8 (ou 4) elementos de cada lado sao
+//    comparados todos contra todos (o bloco de b eh rotacionado e comparado
+//    com o de a) e avanca o bloco de menor maximo;
+//  - sem SIMD, uma intercalacao escalar.
+// A estrategia usada eh devolvida para que quem chama possa registra-la.
+namespace intersect {
+
+    enum class Strategy {
+        Empty,      // uma das sequencias era vazia
+        Galloping,
+        Avx2,
+        Sse,
+        Scalar
+    };
+
+    // razao de tamanhos a partir da qual o galloping eh usado
+    static const size_t SKEW = 32;
+
+    // nome da estrategia para mensagens
+    inline const char* name(Strategy s){
+        switch(s){
+            case Strategy::Empty: return "empty";
+            case Strategy::Galloping: return "galloping";
+            case Strategy::Avx2: return "avx2";
+            case Strategy::Sse: return "sse";
+            default: return "scalar";
+        }
+    }
+
+    // intercalacao escalar de a[i, na) com b[j, nb)
+    inline void scalar(const int* a, size_t na, const int* b, size_t nb, std::vector<int>& out,
+                       size_t i = 0, size_t j = 0){
+        while(i < na && j < nb){
+            if(a[i] < b[j]){
+                i++;
+            }else if(b[j] < a[i]){
+                j++;
+            }else{
+                out.push_back(a[i]);
+                i++;
+                j++;
+            }
+        }
+    }
+
+    // cada elemento de small eh procurado em large com busca exponencial
+    inline void galloping(const int* small, size_t ns, const int* large, size_t nl, std::vector<int>& out){
+        size_t lo = 0;
+        for(size_t i = 0; i < ns && lo < nl; i++){
+            int x = small[i];
+            size_t bound = 1;
+            while(lo + bound < nl && large[lo + bound] < x){
+                bound *= 2;
+            }
+            size_t end = std::min(lo + bound + 1, nl);
+            lo = std::lower_bound(large + lo + bound / 2, large + end, x) - large;
+            if(lo < nl && large[lo] == x){
+                out.push_back(x);
+                lo++;
+            }
+        }
+    }
+
+#if defined(__SSE2__)
+    // blocos de 4: o bloco de b eh comparado em suas 4 rotacoes
+    inline void sse(const int* a, size_t na, const int* b, size_t nb, std::vector<int>& out){
+        size_t i = 0, j = 0;
+        while(i + 4 <= na && j + 4 <= nb){
+            __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+            __m128i m = _mm_cmpeq_epi32(va, vb);
+            m = _mm_or_si128(m, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1))));
+            m = _mm_or_si128(m, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))));
+            m = _mm_or_si128(m, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3))));
+            for(int mask = _mm_movemask_ps(_mm_castsi128_ps(m)); mask != 0; mask &= mask - 1){
+                out.push_back(a[i + __builtin_ctz(mask)]);
+            }
+            int amax = a[i + 3];
+            int bmax = b[j + 3];
+            if(amax <= bmax){
+                i += 4;
+            }
+            if(bmax <= amax){
+                j += 4;
+            }
+        }
+        scalar(a, na, b, nb, out, i, j);
+    }
+#endif
+
+#if defined(__AVX2__)
+    // blocos de 8: o bloco de b eh comparado em suas 8 rotacoes
+    inline void avx2(const int* a, size_t na, const int* b, size_t nb, std::vector<int>& out){
+        const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+        size_t i = 0, j = 0;
+        while(i + 8 <= na && j + 8 <= nb){
+            __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j));
+            __m256i m = _mm256_cmpeq_epi32(va, vb);
+            for(int r = 1; r < 8; r++){
+                vb = _mm256_permutevar8x32_epi32(vb, rotate);
+                m = _mm256_or_si256(m, _mm256_cmpeq_epi32(va, vb));
+            }
+            for(int mask = _mm256_movemask_ps(_mm256_castsi256_ps(m)); mask != 0; mask &= mask - 1){
+                out.push_back(a[i + __builtin_ctz(mask)]);
+            }
+            int amax = a[i + 7];
+            int bmax = b[j + 7];
+            if(amax <= bmax){
+                i += 8;
+            }
+            if(bmax <= amax){
+                j += 8;
+            }
+        }
+        scalar(a, na, b, nb, out, i, j);
+    }
+#endif
+
+    // acrescenta a out (em ordem) os elementos comuns a a e b e retorna a
+    // estrategia usada
+    inline Strategy intersect(const int* a, size_t na, const int* b, size_t nb, std::vector<int>& out){
+        if(na == 0 || nb == 0){
+            return Strategy::Empty;
+        }
+        if(na > nb * SKEW){
+            galloping(b, nb, a, na, out);
+            return Strategy::Galloping;
+        }
+        if(nb > na * SKEW){
+            galloping(a, na, b, nb, out);
+            return Strategy::Galloping;
+        }
+        out.reserve(out.size() + std::min(na, nb));
+#if defined(__AVX2__)
+        avx2(a, na, b, nb, out);
+        return Strategy::Avx2;
+#elif defined(__SSE2__)
+        sse(a, na, b, nb, out);
+        return Strategy::Sse;
+#else
+        scalar(a, na, b, nb, out);
+        return Strategy::Scalar;
+#endif
+    }
+
+    inline Strategy intersect(const std::vector<int>& a, const std::vector<int>& b, std::vector<int>& out){
+        return intersect(a.data(), a.size(), b.data(), b.size(), out);
+    }
+}
+
+#endif
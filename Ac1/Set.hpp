@@ -1,12 +1,20 @@
 #ifndef SET_HPP
 #define SET_HPP
 #include "Node.hpp"
-#include <queue>
+#include "Intersect.hpp"
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <future>
+#include <thread>
+#include <stdexcept>
+#include <system_error>
 
 class Set{
     public:
     Set(){
         _root = nullptr;
+        _strategy = intersect::Strategy::Empty;
     }
     
     ~Set(){
@@ -76,38 +84,117 @@ class Set{
         _Show(this->_root);
     }
 
+    // move as chaves menores que key para left e as maiores para right
+    // (substituindo o conteudo deles) e esvazia este conjunto; retorna true
+    // se key estava no conjunto. O(log n).
+    bool Split(int key, Set* left, Set* right){
+        if(left == right){
+            throw std::runtime_error("The split sets must be distinct.");
+        }
+        Node* node = _root;
+        _root = nullptr;
+        Node* l;
+        Node* r;
+        Node* found = _split(node, key, l, r);
+        delete found;
+        left->Clear();
+        right->Clear();
+        left->_root = l;
+        right->_root = r;
+        return found != nullptr;
+    }
+
+    // substitui o conteudo por left, key e right, esvaziando left e right;
+    // as chaves de left devem ser menores que key e as de right maiores.
+    // O(|altura de left - altura de right|).
+    void Join(Set* left, int key, Set* right){
+        if(left == right){
+            throw std::runtime_error("The joined sets must be distinct.");
+        }
+        if((left->_root != nullptr && _last(left->_root)->key >= key) ||
+           (right->_root != nullptr && _first(right->_root)->key <= key)){
+            throw std::runtime_error("The sets can not be joined at this key.");
+        }
+        Node* l = left->_root;
+        Node* r = right->_root;
+        left->_root = nullptr;
+        right->_root = nullptr;
+        _root = _clear(_root);
+        _root = _join(l, new Node(key), r);
+    }
+
+    // as tres operacoes abaixo alteram este conjunto e so leem x. Para cada
+    // no de x este conjunto eh cortado (split) na chave do no e as metades
+    // sao combinadas recursivamente com as subarvores de x e depois
+    // juntadas (join), entao custam O(m log(n/m + 1)) com m = |x| <= n, em
+    // vez do O(n + m) das versoes que achatam as arvores. Quando as duas
+    // metades sao grandes elas sao processadas em paralelo (fork-join).
+
+    // este conjunto passa a ser este uniao x
+    void UnionWith(Set* x){
+        if(x != this){
+            _root = _union(_root, x->_root, _forks());
+        }
+    }
+
+    // este conjunto passa a ser este intersecao x
+    void IntersectWith(Set* x){
+        if(x != this){
+            _root = _intersection(_root, x->_root, _forks());
+        }
+    }
+
+    // este conjunto passa a ser este menos x
+    void DifferenceWith(Set* x){
+        if(x == this){
+            Clear();
+        }else{
+            _root = _difference(_root, x->_root, _forks());
+        }
+    }
+
     void Show() const {
         _Show(_root);
     }
 
+    // chaves do conjunto em ordem crescente
+    std::vector<int> Export() const {
+        std::vector<int> keys;
+        keys.reserve(Size());
+        _flatten(_root, keys);
+        return keys;
+    }
+
+    // substitui o conteudo pelas chaves de keys, que devem estar em ordem
+    // crescente e sem repeticoes (como as de Export)
+    void Import(const std::vector<int>& keys){
+        for(size_t i = 1; i < keys.size(); i++){
+            if(keys[i - 1] >= keys[i]){
+                throw std::runtime_error("The provided keys are not sorted.");
+            }
+        }
+        _assign(keys);
+    }
+
+    // estrategia usada pela ultima Intersection
+    intersect::Strategy IntersectionStrategy() const {
+        return _strategy;
+    }
+
+    // substitui o conteudo pelo de x (nullptr esvazia o conjunto)
     void operator=(Set* x){
         if(x == nullptr){
             this->Clear();
         }else{
-            std::queue<Node*> fila;
-        
-        if(x->_root != nullptr){
-            fila.push(x->_root);
-            while(!(fila.empty())){
-                Node* aux = fila.front();
-                if(aux->left != nullptr){
-                    fila.push(aux->left);
-                }
-                
-                if(aux->right != nullptr){
-                    fila.push(aux->right);
-                }
-    
-                Node* N = fila.front();
-                this->Insert(N->key);
-                fila.pop();
-            }
-        }
+            std::vector<int> keys;
+            _flatten(x->_root, keys);
+            _assign(keys);
         }
     }
 
     private:
     Node* _root;
+    intersect::Strategy _strategy; // da ultima Intersection
     
     Node* _insert(Node* node, int k){
         if(node == nullptr){
@@ -306,96 +393,292 @@ class Set{
         x->_root->right = rt;
     }
 
+    // as tres operacoes achatam as arvores em vetores ordenados (percurso
+    // em ordem), combinam os vetores com uma intercalacao linear e montam
+    // a arvore do resultado ja balanceada: O(n + m), sem rotacoes. Os
+    // elementos que ja estavam neste conjunto sao mantidos. A intersecao usa
+    // intersect::intersect (galloping ou blocos SIMD, ver Intersect.hpp), ou
+    // desce pela arvore maior quando os tamanhos sao muito diferentes.
     void _Union(Set* x, Set* y){
-        std::queue<Node*> fila;
-        
-        if(x->_root != nullptr){
-            fila.push(x->_root);
-            while(!(fila.empty())){
-                Node* aux = fila.front();
-                if(aux->left != nullptr){
-                    fila.push(aux->left);
-                }
-                
-                if(aux->right != nullptr){
-                    fila.push(aux->right);
-                }
-    
-                Node* N = fila.front();
-                this->Insert(N->key);
-                fila.pop();
-            }
-        }
-
-        if(y->_root != nullptr){
-            fila.push(y->_root);
-            while(!(fila.empty())){
-                Node* aux = fila.front();
-                if(aux->left != nullptr){
-                    fila.push(aux->left);
-                }
-                
-                if(aux->right != nullptr){
-                    fila.push(aux->right);
-                }
-                
-                Node* N = fila.front();
-                this->Insert(N->key);
-                fila.pop();
-            }
-        }
+        std::vector<int> a, b, result;
+        _flatten(x->_root, a);
+        _flatten(y->_root, b);
+        std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+        _keep(result);
 
         this->Show();
     }
     
+    // so a arvore mais baixa eh achatada. Se a outra tem com certeza (pela
+    // altura) SKEW vezes mais nos, ela nem eh achatada: as chaves ordenadas
+    // descem por ela (_probe), em O(m log(n/m + 1)); senao as duas viram
+    // vetores e intersect::intersect escolhe a estrategia
     void _Intersection(Set* x, Set* y){
-        if(x->_root == nullptr || x->_root == nullptr){
-            return;
-        }
-        std::queue<Node*> fila;
-        while(!(fila.empty())){
-            Node* aux = fila.front();
-            if(aux->left != nullptr){
-                fila.push(aux->left);
-            }
-                
-            if(aux->right != nullptr){
-                fila.push(aux->right);
-            }
-    
-            Node* N = fila.front();
-            if(y->Contains(N->key)){
-                this->Insert(N->key);
-            }
-                
-            fila.pop();
+        Set* small = _height(x->_root) <= _height(y->_root) ? x : y;
+        Set* large = small == x ? y : x;
+        std::vector<int> a, result;
+        _flatten(small->_root, a);
+        if(a.empty()){
+            _strategy = intersect::Strategy::Empty;
+        }else if(_minimumSize(_height(large->_root)) / intersect::SKEW >= a.size()){
+            _probe(large->_root, a.data(), a.data() + a.size(), result);
+            _strategy = intersect::Strategy::Galloping;
+        }else{
+            std::vector<int> b;
+            _flatten(large->_root, b);
+            _strategy = intersect::intersect(a, b, result);
         }
+        _keep(result);
+
         _Show(this->_root); 
     } 
 
     void _Difference(Set* x, Set* y){
-        std::queue<Node*> fila;
+        std::vector<int> a, b, result;
+        _flatten(x->_root, a);
+        _flatten(y->_root, b);
+        std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+        _keep(result);
+    }
 
-        if(x->_root == nullptr){
-            return;
+    // acrescenta a out, em ordem, as chaves de [first, last) (ordenadas) que
+    // estao na subarvore: cada no divide o intervalo com uma busca binaria e
+    // a descida para quando o intervalo ou a subarvore fica vazio
+    void _probe(Node* node, const int* first, const int* last, std::vector<int>& out) const {
+        if(node == nullptr || first == last)return;
+
+        const int* middle = std::lower_bound(first, last, node->key);
+        _probe(node->left, first, middle, out);
+        if(middle != last && *middle == node->key){
+            out.push_back(node->key);
+            middle++;
         }
+        _probe(node->right, middle, last, out);
+    }
 
-        fila.push(x->_root);
-        while(!(fila.empty())){
-            Node* aux = fila.front();
-            if(aux->left != nullptr){
-                fila.push(aux->left);
-            }
-            
-            if(aux->right != nullptr){
-                fila.push(aux->right);
-            }
+    // menor numero de nos de uma arvore AVL com a altura dada
+    static size_t _minimumSize(int height){
+        size_t previous = 0, current = 0;
+        for(int h = 1; h <= height; h++){
+            size_t next = (h == 1) ? 1 : current + previous + 1;
+            previous = current;
+            current = next;
+        }
+        return current;
+    }
 
-            if(!(y->Contains(aux->key))){
-                this->Insert(aux->key);
+    // acrescenta ao fim de out as chaves da subarvore em ordem crescente
+    void _flatten(Node* node, std::vector<int>& out) const {
+        if(node == nullptr)return;
+
+        _flatten(node->left, out);
+        out.push_back(node->key);
+        _flatten(node->right, out);
+    }
+
+    // monta uma arvore AVL perfeitamente balanceada com keys[begin, end),
+    // que deve estar em ordem crescente e sem repeticoes
+    Node* _build(const std::vector<int>& keys, int begin, int end){
+        if(begin >= end){
+            return nullptr;
+        }
+        int middle = begin + (end - begin) / 2;
+        Node* node = new Node(keys[middle]);
+        node->left = _build(keys, begin, middle);
+        node->right = _build(keys, middle + 1, end);
+        node->height = 1 + std::max(_height(node->left), _height(node->right));
+        return node;
+    }
+
+    // troca o conteudo do conjunto pelas chaves ordenadas de keys
+    void _assign(const std::vector<int>& keys){
+        _root = _clear(_root);
+        _root = _build(keys, 0, static_cast<int>(keys.size()));
+    }
+
+    // une as chaves ordenadas de keys as que o conjunto ja tem
+    void _keep(std::vector<int>& keys){
+        if(_root != nullptr){
+            std::vector<int> mine, merged;
+            _flatten(_root, mine);
+            std::set_union(mine.begin(), mine.end(), keys.begin(), keys.end(), std::back_inserter(merged));
+            keys.swap(merged);
+        }
+        _assign(keys);
+    }
+
+    // altura minima das duas metades para processa-las em paralelo (uma
+    // arvore AVL com essa altura tem pelo menos ~2500 nos)
+    static constexpr int FORK_HEIGHT = 16;
+
+    // niveis de fork-join: log2 do numero de threads do hardware
+    static int _forks(){
+        unsigned threads = std::thread::hardware_concurrency();
+        int levels = 0;
+        while((1u << levels) < threads){
+            levels++;
+        }
+        return levels;
+    }
+
+    // executa left() e right(), em paralelo se parallel for true. Se a
+    // thread nao puder ser criada, left() roda aqui mesmo: uma excecao no
+    // meio de um split deixaria a arvore desmontada
+    template <typename Left, typename Right>
+    static void _fork(bool parallel, Left left, Right right){
+        std::future<void> task;
+        if(parallel){
+            try{
+                task = std::async(std::launch::async, left);
+            }catch(const std::system_error&){
             }
-            fila.pop();
         }
+        if(!task.valid()){
+            left();
+        }
+        right();
+        if(task.valid()){
+            task.get();
+        }
+    }
+
+    Node* _first(Node* node) const {
+        while(node->left != nullptr){
+            node = node->left;
+        }
+        return node;
+    }
+
+    Node* _last(Node* node) const {
+        while(node->right != nullptr){
+            node = node->right;
+        }
+        return node;
+    }
+
+    // junta l, o no k e r (chaves de l < k->key < chaves de r) em uma arvore
+    // AVL: desce pela borda da arvore mais alta ate uma subarvore com altura
+    // proxima da outra, pendura k ali e rebalanceia na volta.
+    // O(|altura de l - altura de r|).
+    Node* _join(Node* l, Node* k, Node* r){
+        if(_height(l) > _height(r) + 1){
+            l->right = _join(l->right, k, r);
+            return fixup_deletion(l);
+        }
+        if(_height(r) > _height(l) + 1){
+            r->left = _join(l, k, r->left);
+            return fixup_deletion(r);
+        }
+        k->left = l;
+        k->right = r;
+        k->height = 1 + std::max(_height(l), _height(r));
+        return k;
+    }
+
+    // junta l e r (chaves de l < chaves de r) sem chave do meio: o maior no
+    // de l faz esse papel
+    Node* _join(Node* l, Node* r){
+        if(l == nullptr){
+            return r;
+        }
+        Node* last;
+        Node* rest = _removeLast(l, last);
+        return _join(rest, last, r);
+    }
+
+    // tira o maior no da arvore (em last) e retorna o resto
+    Node* _removeLast(Node* node, Node*& last){
+        if(node->right == nullptr){
+            last = node;
+            Node* rest = node->left;
+            node->left = nullptr;
+            node->height = 1;
+            return rest;
+        }
+        Node* rest = _removeLast(node->right, last);
+        return _join(node->left, node, rest);
+    }
+
+    // corta a arvore em l (chaves < key) e r (chaves > key); retorna o no
+    // com key, desligado da arvore, ou nullptr. O(log n).
+    Node* _split(Node* node, int key, Node*& l, Node*& r){
+        if(node == nullptr){
+            l = r = nullptr;
+            return nullptr;
+        }
+        Node* left = node->left;
+        Node* right = node->right;
+        if(key == node->key){
+            l = left;
+            r = right;
+            node->left = node->right = nullptr;
+            node->height = 1;
+            return node;
+        }
+        Node* found;
+        if(key < node->key){
+            Node* middle;
+            found = _split(left, key, l, middle);
+            r = _join(middle, node, right);
+        }else{
+            Node* middle;
+            found = _split(right, key, middle, r);
+            l = _join(left, node, middle);
+        }
+        return found;
+    }
+
+    // as tres operacoes consomem a e so leem b (os nos novos sao copias das
+    // chaves de b); forks eh o numero de niveis que ainda podem se dividir
+    Node* _union(Node* a, const Node* b, int forks){
+        if(b == nullptr){
+            return a;
+        }
+        Node* l;
+        Node* r;
+        Node* middle = _split(a, b->key, l, r);
+        if(middle == nullptr){
+            middle = new Node(b->key);
+        }
+        bool parallel = forks > 0 && std::min(_height(l), _height(b->left)) >= FORK_HEIGHT &&
+                        std::min(_height(r), _height(b->right)) >= FORK_HEIGHT;
+        _fork(parallel,
+              [&]{ l = _union(l, b->left, forks - 1); },
+              [&]{ r = _union(r, b->right, forks - 1); });
+        return _join(l, middle, r);
+    }
+
+    Node* _intersection(Node* a, const Node* b, int forks){
+        if(a == nullptr || b == nullptr){
+            return _clear(a);
+        }
+        Node* l;
+        Node* r;
+        Node* middle = _split(a, b->key, l, r);
+        bool parallel = forks > 0 && std::min(_height(l), _height(b->left)) >= FORK_HEIGHT &&
+                        std::min(_height(r), _height(b->right)) >= FORK_HEIGHT;
+        _fork(parallel,
+              [&]{ l = _intersection(l, b->left, forks - 1); },
+              [&]{ r = _intersection(r, b->right, forks - 1); });
+        if(middle == nullptr){
+            return _join(l, r);
+        }
+        return _join(l, middle, r);
+    }
+
+    Node* _difference(Node* a, const Node* b, int forks){
+        if(a == nullptr || b == nullptr){
+            return a;
+        }
+        Node* l;
+        Node* r;
+        delete _split(a, b->key, l, r);
+        bool parallel = forks > 0 && std::min(_height(l), _height(b->left)) >= FORK_HEIGHT &&
+                        std::min(_height(r), _height(b->right)) >= FORK_HEIGHT;
+        _fork(parallel,
+              [&]{ l = _difference(l, b->left, forks - 1); },
+              [&]{ r = _difference(r, b->right, forks - 1); });
+        return _join(l, r);
     }
 
     void _Show(Node* node) const {
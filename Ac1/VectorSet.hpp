@@ -0,0 +1,170 @@
+#ifndef VECTORSET_HPP
+#define VECTORSET_HPP
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+#include "Intersect.hpp"
+
+// Conjunto de int guardado em um vetor ordenado e sem repeticoes, com a
+// mesma interface (e as mesmas mensagens) do Set. Ocupa 4 bytes por
+// elemento, contiguos; as buscas sao binarias e as operacoes de conjunto
+// sao intercalacoes lineares. Insert e Erase deslocam o fim do vetor, entao
+// eh indicado para conjuntos montados de uma vez e consultados muitas vezes.
+class VectorSet{
+    public:
+    VectorSet(){
+        _strategy = intersect::Strategy::Empty;
+    }
+
+    void Insert(int k){
+        auto it = std::lower_bound(_keys.begin(), _keys.end(), k);
+        if(it == _keys.end() || *it != k){
+            _keys.insert(it, k);
+        }
+    }
+
+    void Clear(){
+        _keys.clear();
+    }
+
+    void Erase(int k){
+        auto it = std::lower_bound(_keys.begin(), _keys.end(), k);
+        if(it != _keys.end() && *it == k){
+            _keys.erase(it);
+        }
+    }
+
+    bool Contains(int k) const {
+        return std::binary_search(_keys.begin(), _keys.end(), k);
+    }
+
+    bool Empty() const {
+        return _keys.empty();
+    }
+
+    int Size() const {
+        return static_cast<int>(_keys.size());
+    }
+
+    int Minimum() const {
+        if(Empty()){
+            throw std::runtime_error("The provided set is empty.");
+        }
+        return _keys.front();
+    }
+
+    int Maximum() const {
+        if(Empty()){
+            throw std::runtime_error("The provided set is empty.");
+        }
+        return _keys.back();
+    }
+
+    int Successor(int x) const {
+        if(!Contains(x)){
+            throw std::runtime_error("The set does not contains this element.");
+        }
+        auto it = std::upper_bound(_keys.begin(), _keys.end(), x);
+        if(it == _keys.end()){
+            throw std::runtime_error("The element does not have a Successor in the set.");
+        }
+        std::cout << "the successor is: ";
+        return *it;
+    }
+
+    int Predecessor(int x) const {
+        if(!Contains(x)){
+            throw std::runtime_error("The set does not contains this element.");
+        }
+        auto it = std::lower_bound(_keys.begin(), _keys.end(), x);
+        if(it == _keys.begin()){
+            throw std::runtime_error("The element does not have a Predecessor in the set.");
+        }
+        std::cout << "the predecessor is: ";
+        return *(it - 1);
+    }
+
+    void Swap(VectorSet* x){
+        _keys.swap(x->_keys);
+    }
+
+    void Union(VectorSet* x, VectorSet* y){
+        std::vector<int> result;
+        std::set_union(x->_keys.begin(), x->_keys.end(), y->_keys.begin(), y->_keys.end(),
+                       std::back_inserter(result));
+        _keep(result);
+        Show();
+    }
+
+    void Intersection(VectorSet* x, VectorSet* y){
+        std::vector<int> result;
+        _strategy = intersect::intersect(x->_keys, y->_keys, result);
+        _keep(result);
+        Show();
+    }
+
+    void Difference(VectorSet* x, VectorSet* y){
+        std::vector<int> result;
+        std::set_difference(x->_keys.begin(), x->_keys.end(), y->_keys.begin(), y->_keys.end(),
+                            std::back_inserter(result));
+        _keep(result);
+        Show();
+    }
+
+    // chaves do conjunto em ordem crescente
+    const std::vector<int>& Export() const {
+        return _keys;
+    }
+
+    // substitui o conteudo pelas chaves de keys, que devem estar em ordem
+    // crescente e sem repeticoes
+    void Import(const std::vector<int>& keys){
+        for(size_t i = 1; i < keys.size(); i++){
+            if(keys[i - 1] >= keys[i]){
+                throw std::runtime_error("The provided keys are not sorted.");
+            }
+        }
+        _keys = keys;
+    }
+
+    // estrategia usada pela ultima Intersection
+    intersect::Strategy IntersectionStrategy() const {
+        return _strategy;
+    }
+
+    void Show() const {
+        for(int k : _keys){
+            std::cout << k << " ";
+        }
+    }
+
+    // substitui o conteudo pelo de x (nullptr esvazia o conjunto)
+    void operator=(VectorSet* x){
+        if(x == nullptr){
+            Clear();
+        }else if(x != this){
+            _keys = x->_keys;
+        }
+    }
+
+    private:
+    std::vector<int> _keys; // em ordem crescente, sem repeticoes
+    intersect::Strategy _strategy; // da ultima Intersection
+
+    // une result as chaves que o conjunto ja tem (como o Set, as operacoes
+    // acrescentam o resultado ao conjunto)
+    void _keep(std::vector<int>& result){
+        if(!_keys.empty()){
+            std::vector<int> merged;
+            std::set_union(_keys.begin(), _keys.end(), result.begin(), result.end(),
+                           std::back_inserter(merged));
+            result.swap(merged);
+        }
+        _keys.swap(result);
+    }
+};
+
+#endif
@@ -1,5 +1,13 @@
+// Uso: ./main [avl|vector|bitmap]
+// O argumento escolhe a implementacao dos conjuntos: arvore AVL (Set.hpp,
+// o padrao), vetor ordenado (VectorSet.hpp) ou bitmap comprimido
+// (BitmapSet.hpp). Os comandos e as mensagens sao os mesmos.
 #include <iostream>
+#include <string>
+#include <vector>
 #include "Set.hpp"
+#include "VectorSet.hpp"
+#include "BitmapSet.hpp"
 using namespace std;
 
 void comands(){
@@ -24,7 +32,8 @@ void comands(){
             "Exit"<< endl << endl;
 }
 
-void Show(vector<Set*> x){
+template <typename SetType>
+void Show(vector<SetType*> x){
     for(int i = 0; i < x.size(); i++){
         cout << "Set " << i << ": ";
         x.at(i)->Show();
@@ -32,8 +41,9 @@ void Show(vector<Set*> x){
     }
 }
 
-int main(){
-    vector<Set*> conjuntos;
+template <typename SetType>
+int run(){
+    vector<SetType*> conjuntos;
  
     comands();
     while(true){
@@ -48,7 +58,7 @@ int main(){
             cout << "good bye" << endl;
             break;
         }else if(token == "Create" || token == "create"){
-            Set* set = new Set();
+            SetType* set = new SetType();
             conjuntos.push_back(set);
             cout << "Set number " << conjuntos.size()-1 << " was created." << endl;
         }else if(token == "Insert" || token == "insert"){
@@ -156,7 +166,7 @@ int main(){
             if(conjuntos.size() > 1){
                 cin >> a >> b;
                 cout << "the union of the sets " << a << " and " << b << " is: ";
-                Set* set = new Set();
+                SetType* set = new SetType();
                 set->Union(conjuntos.at(a), conjuntos.at(b));
                 conjuntos.push_back(set);
                 cout << endl << "and was created in the " << conjuntos.size()-1 << " position" << endl;
@@ -167,7 +177,7 @@ int main(){
             if(conjuntos.size() > 1){
                 cin >> a >> b;
                 cout << "the intersection of the sets " << a << " and " << b << " is: ";
-                Set* set = new Set();
+                SetType* set = new SetType();
                 set->Intersection(conjuntos.at(a), conjuntos.at(b));
                 conjuntos.push_back(set);
                 cout << endl << "and was created in the " << conjuntos.size()-1 << " position" << endl;
@@ -178,7 +188,7 @@ int main(){
             if(conjuntos.size() > 1){
                 cin >> a >> b;
                 cout << "the difference of the sets " << a << " and " << b << " is: ";
-                Set* set = new Set();
+                SetType* set = new SetType();
                 set->Difference(conjuntos.at(a), conjuntos.at(b));
                 conjuntos.push_back(set);
                 cout << endl << "and was created in the " << conjuntos.size()-1 << " position" << endl;
@@ -203,7 +213,7 @@ int main(){
         }else if(token == "Igualar" || token == "igualar"){
             if(conjuntos.size() > 1){
                 cin >> a >> b;
-                Set* set = new Set();
+                SetType* set = new SetType();
                 conjuntos.at(a) = conjuntos.at(b);
                 cout << "Now they are equal " << endl;
             }else{
@@ -215,4 +225,17 @@ int main(){
     }
 
     return 0;
+}
+
+int main(int argc, char* argv[]){
+    string tipo = argc > 1 ? argv[1] : "avl";
+    if(tipo == "avl"){
+        return run<Set>();
+    }else if(tipo == "vector"){
+        return run<VectorSet>();
+    }else if(tipo == "bitmap"){
+        return run<BitmapSet>();
+    }
+    cout << "Tipo de conjunto invalido: " << tipo << " (use avl, vector ou bitmap)" << endl;
+    return 1;
 }
\ No newline at end of file
@@ -0,0 +1,335 @@
+#ifndef INDEXEDPQ_HPP
+#define INDEXEDPQ_HPP
+#include <stdexcept>
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+// Fila de prioridade enderecavel: push retorna um handle que continua
+// identificando o elemento enquanto ele sobe e desce no heap, entao sua
+// prioridade pode ser alterada ou ele pode ser removido em O(log n).
+//
+// Cada elemento ocupa um slot: o heap guarda apenas slots, os valores ficam
+// em m_value[slot] e m_pos[slot] guarda a posicao atual do slot no heap
+// (atualizada a cada movimento dos sifts). Quando um elemento sai da fila
+// (pop, erase ou clear) seu slot eh liberado e pode ser reusado por um push
+// posterior.
+//
+// O handle eh o slot (32 bits baixos) junto com a geracao do slot (32 bits
+// altos), que aumenta cada vez que o slot eh liberado. Assim um handle
+// guardado depois que seu elemento saiu da fila nao eh confundido com o
+// elemento que reusou o slot: contains() retorna false e as demais operacoes
+// lancam out_of_range.
+template <typename T, typename Comparator>
+class IndexedPq {
+public:
+    using Handle = uint64_t;
+
+private:
+    // posicao de um slot que nao esta na fila
+    static constexpr size_t NOT_IN_HEAP = static_cast<size_t>(-1);
+
+    // maior quantidade de slots (o slot ocupa 32 bits do handle)
+    static constexpr size_t MAX_SLOTS = UINT32_MAX;
+
+    std::vector<size_t> m_heap;   // heap de slots (1-indexado, m_heap[0] nao eh usado)
+    std::vector<T> m_value;       // valor de cada slot
+    std::vector<size_t> m_pos;    // posicao de cada slot em m_heap
+    std::vector<uint32_t> m_generation; // geracao atual de cada slot
+    std::vector<size_t> m_free;   // slots liberados para reuso
+    Comparator compara;
+
+public:
+    // Construtor
+    IndexedPq();
+
+    // retorna o número de elementos na fila
+    size_t size() const;
+
+    // retorna true se e somente se a fila esta vazia
+    bool empty() const;
+
+    // insere um elemento na fila e retorna seu handle
+    Handle push(const T& element);
+
+    // insere um elemento na fila movendo-o e retorna seu handle
+    Handle push(T&& element);
+
+    // retorna o valor do elemento prioritario
+    const T& top() const;
+
+    // retorna o handle do elemento prioritario
+    Handle top_handle() const;
+
+    // remove o elemento prioritario e o retorna
+    T pop();
+
+    // retorna true se e somente se o handle esta na fila
+    bool contains(Handle h) const;
+
+    // retorna o valor associado ao handle
+    const T& at(Handle h) const;
+
+    // torna o elemento h mais prioritario (newPriority nao pode ser
+    // menos prioritario que o valor atual) e o faz subir no heap
+    void decrease_key(Handle h, const T& newPriority);
+
+    // troca o valor de h por um qualquer e o reposiciona
+    void update(Handle h, const T& newValue);
+
+    // remove o elemento h da fila
+    void erase(Handle h);
+
+    // esvazia a fila; todos os handles deixam de ser validos
+    void clear();
+
+private:
+    // retorna o slot de h, lancando out_of_range se h nao estiver na fila
+    size_t check(Handle h) const;
+
+    // retorna o handle atual do slot
+    Handle handleOf(size_t slot) const;
+
+    // libera o slot para reuso, invalidando seus handles
+    void release(size_t slot);
+
+    // obtem um slot livre para o valor element
+    template <typename U>
+    size_t acquire(U&& element);
+
+    // remove o slot da posicao index do heap
+    void removeAt(size_t index);
+
+    // coloca slot na posicao index do heap atualizando m_pos
+    void place(size_t index, size_t slot);
+
+    // recebe como entrada um indice e faz
+    // o slot m_heap[index] descer no heap
+    void fixDown(size_t index);
+
+    // recebe como entrada um indice e faz
+    // o slot m_heap[index] subir no heap
+    void fixUp(size_t index);
+};
+
+// ----------------------------------------------------------------
+
+// construtor default
+template <typename T, typename Comparator>
+IndexedPq<T, Comparator>::IndexedPq() {
+    m_heap.push_back(0);
+}
+
+// retorna o número de elementos na fila
+template <typename T, typename Comparator>
+size_t IndexedPq<T, Comparator>::size() const {
+    return m_heap.size() - 1;
+}
+
+// retorna true se e somente se a fila esta vazia
+template <typename T, typename Comparator>
+bool IndexedPq<T, Comparator>::empty() const {
+    return m_heap.size() == 1;
+}
+
+// insere um elemento na fila e retorna seu handle
+template <typename T, typename Comparator>
+typename IndexedPq<T, Comparator>::Handle IndexedPq<T, Comparator>::push(const T& element) {
+    size_t slot = acquire(element);
+    m_heap.push_back(slot);
+    m_pos[slot] = m_heap.size() - 1;
+    fixUp(m_heap.size() - 1);
+    return handleOf(slot);
+}
+
+// insere um elemento na fila movendo-o e retorna seu handle
+template <typename T, typename Comparator>
+typename IndexedPq<T, Comparator>::Handle IndexedPq<T, Comparator>::push(T&& element) {
+    size_t slot = acquire(std::move(element));
+    m_heap.push_back(slot);
+    m_pos[slot] = m_heap.size() - 1;
+    fixUp(m_heap.size() - 1);
+    return handleOf(slot);
+}
+
+// retorna o valor do elemento prioritario
+template <typename T, typename Comparator>
+const T& IndexedPq<T, Comparator>::top() const {
+    if(empty()) {
+        throw std::underflow_error("empty queue");
+    }
+    return m_value[m_heap[1]];
+}
+
+// retorna o handle do elemento prioritario
+template <typename T, typename Comparator>
+typename IndexedPq<T, Comparator>::Handle IndexedPq<T, Comparator>::top_handle() const {
+    if(empty()) {
+        throw std::underflow_error("empty queue");
+    }
+    return handleOf(m_heap[1]);
+}
+
+// remove o elemento prioritario e o retorna
+template <typename T, typename Comparator>
+T IndexedPq<T, Comparator>::pop() {
+    if(empty()) {
+        throw std::underflow_error("empty queue");
+    }
+    T element = std::move(m_value[m_heap[1]]);
+    removeAt(1);
+    return element;
+}
+
+// retorna true se e somente se o handle esta na fila
+template <typename T, typename Comparator>
+bool IndexedPq<T, Comparator>::contains(Handle h) const {
+    size_t slot = static_cast<size_t>(h & UINT32_MAX);
+    return slot < m_pos.size() && m_generation[slot] == (h >> 32) && m_pos[slot] != NOT_IN_HEAP;
+}
+
+// retorna o valor associado ao handle
+template <typename T, typename Comparator>
+const T& IndexedPq<T, Comparator>::at(Handle h) const {
+    return m_value[check(h)];
+}
+
+// torna o elemento h mais prioritario e o faz subir no heap
+template <typename T, typename Comparator>
+void IndexedPq<T, Comparator>::decrease_key(Handle h, const T& newPriority) {
+    size_t slot = check(h);
+    if(compara(newPriority, m_value[slot])) {
+        throw std::underflow_error("Invalid key");
+    }
+    m_value[slot] = newPriority;
+    fixUp(m_pos[slot]);
+}
+
+// troca o valor de h e o faz subir ou descer conforme o novo valor
+template <typename T, typename Comparator>
+void IndexedPq<T, Comparator>::update(Handle h, const T& newValue) {
+    size_t slot = check(h);
+    bool up = compara(m_value[slot], newValue);
+    m_value[slot] = newValue;
+    if(up) {
+        fixUp(m_pos[slot]);
+    } else {
+        fixDown(m_pos[slot]);
+    }
+}
+
+// remove o elemento h da fila
+template <typename T, typename Comparator>
+void IndexedPq<T, Comparator>::erase(Handle h) {
+    removeAt(m_pos[check(h)]);
+}
+
+// esvazia a fila; os slots sao liberados (e nao descartados) para que as
+// geracoes continuem invalidando os handles antigos
+template <typename T, typename Comparator>
+void IndexedPq<T, Comparator>::clear() {
+    for(size_t i = 1; i < m_heap.size(); i++) {
+        release(m_heap[i]);
+    }
+    m_heap.resize(1);
+}
+
+// lanca out_of_range se h nao estiver na fila
+template <typename T, typename Comparator>
+size_t IndexedPq<T, Comparator>::check(Handle h) const {
+    if(!contains(h)) {
+        throw std::out_of_range("handle not in queue");
+    }
+    return static_cast<size_t>(h & UINT32_MAX);
+}
+
+// o handle junta a geracao (32 bits altos) e o slot (32 bits baixos)
+template <typename T, typename Comparator>
+typename IndexedPq<T, Comparator>::Handle IndexedPq<T, Comparator>::handleOf(size_t slot) const {
+    return (static_cast<Handle>(m_generation[slot]) << 32) | slot;
+}
+
+// tira o slot da fila e muda sua geracao
+template <typename T, typename Comparator>
+void IndexedPq<T, Comparator>::release(size_t slot) {
+    m_pos[slot] = NOT_IN_HEAP;
+    m_generation[slot]++;
+    m_free.push_back(slot);
+}
+
+// reaproveita um slot liberado ou cria um novo
+template <typename T, typename Comparator>
+template <typename U>
+size_t IndexedPq<T, Comparator>::acquire(U&& element) {
+    if(!m_free.empty()) {
+        size_t slot = m_free.back();
+        m_free.pop_back();
+        m_value[slot] = std::forward<U>(element);
+        return slot;
+    }
+    if(m_value.size() >= MAX_SLOTS) {
+        throw std::length_error("too many elements");
+    }
+    m_value.push_back(std::forward<U>(element));
+    m_pos.push_back(NOT_IN_HEAP);
+    m_generation.push_back(0);
+    return m_value.size() - 1;
+}
+
+// remove o slot da posicao index: o ultimo slot ocupa a posicao
+// e sobe ou desce conforme seu valor
+template <typename T, typename Comparator>
+void IndexedPq<T, Comparator>::removeAt(size_t index) {
+    size_t slot = m_heap[index];
+    size_t moved = m_heap.back();
+    m_heap.pop_back();
+    release(slot);
+    if(index < m_heap.size()) {
+        place(index, moved);
+        if(index > 1 && compara(m_value[m_heap[index/2]], m_value[moved])) {
+            fixUp(index);
+        } else {
+            fixDown(index);
+        }
+    }
+}
+
+// coloca slot na posicao index do heap atualizando m_pos
+template <typename T, typename Comparator>
+void IndexedPq<T, Comparator>::place(size_t index, size_t slot) {
+    m_heap[index] = slot;
+    m_pos[slot] = index;
+}
+
+// faz o slot m_heap[index] subir no heap: os pais menos
+// prioritarios descem para o "buraco"
+template <typename T, typename Comparator>
+void IndexedPq<T, Comparator>::fixUp(size_t index) {
+    size_t h = m_heap[index];
+    while(index != 1 && compara(m_value[m_heap[index/2]], m_value[h])) {
+        place(index, m_heap[index/2]);
+        index = index/2;
+    }
+    place(index, h);
+}
+
+// faz o slot m_heap[index] descer no heap: o filho mais
+// prioritario sobe para o "buraco"
+template <typename T, typename Comparator>
+void IndexedPq<T, Comparator>::fixDown(size_t index) {
+    size_t h = m_heap[index];
+    size_t n = m_heap.size() - 1;
+    while(2*index <= n) {
+        size_t ipriority = 2*index;
+        if(ipriority + 1 <= n && compara(m_value[m_heap[ipriority]], m_value[m_heap[ipriority + 1]]))
+            ipriority = ipriority + 1;
+        if(!compara(m_value[h], m_value[m_heap[ipriority]]))
+            break;
+        place(index, m_heap[ipriority]);
+        index = ipriority;
+    }
+    place(index, h);
+}
+
+#endif
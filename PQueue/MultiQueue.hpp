@@ -0,0 +1,206 @@
+#ifndef MULTIQUEUE_HPP
+#define MULTIQUEUE_HPP
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <thread>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+#include "Pq.hpp"
+
+// Fila de prioridade concorrente no estilo MultiQueue: c * threads heaps
+// (Pq), cada um com seu proprio mutex e em sua propria linha de cache.
+//
+// push escolhe um heap aleatorio e insere nele. pop sorteia dois heaps,
+// compara seus topos e remove do mais prioritario. Os locks sao tomados com
+// try_lock; se um heap esta ocupado outro par eh sorteado, entao as threads
+// quase nunca esperam umas pelas outras.
+//
+// Garantias (ordem relaxada):
+//  - cada elemento inserido eh removido exatamente uma vez;
+//  - pop NAO eh linearizavel como em uma fila unica: ele retorna um dos
+//    elementos mais prioritarios, mas nao necessariamente o primeiro. O erro
+//    de posicao esperado eh O(numero de heaps) e O(heaps * log(heaps)) com
+//    alta probabilidade;
+//  - elementos inseridos pela mesma thread nao saem necessariamente na
+//    ordem de prioridade entre si;
+//  - try_pop so retorna false depois de encontrar todos os heaps vazios em
+//    uma varredura, mas pode deixar de ver um push concorrente a ela;
+//  - size() eh aproximado enquanto houver operacoes em andamento.
+template <typename T, typename Comparator, int D = 2>
+class MultiQueue {
+private:
+    // um heap e seu lock, isolados em uma linha de cache
+    struct alignas(PQ_CACHE_LINE) Shard {
+        std::mutex lock;
+        Pq<T, Comparator, D> heap;
+    };
+
+    std::unique_ptr<Shard[]> m_shards; // heaps
+    size_t m_count;                    // numero de heaps
+    alignas(PQ_CACHE_LINE) std::atomic<long> m_size; // elementos na fila
+    Comparator compara;
+
+public:
+    // Construtor: cria c * threads heaps (pelo menos 2)
+    explicit MultiQueue(unsigned threads = std::thread::hardware_concurrency(), unsigned c = 2);
+
+    MultiQueue(const MultiQueue&) = delete;
+    MultiQueue& operator=(const MultiQueue&) = delete;
+
+    // insere um elemento em um heap aleatorio
+    void push(const T& element);
+
+    // insere um elemento em um heap aleatorio movendo-o
+    void push(T&& element);
+
+    // remove um dos elementos mais prioritarios e o coloca em out;
+    // retorna false se todos os heaps estavam vazios
+    bool try_pop(T& out);
+
+    // retorna o número (aproximado) de elementos na fila
+    size_t size() const;
+
+    // retorna true se a fila (aproximadamente) esta vazia
+    bool empty() const;
+
+    // retorna o numero de heaps
+    size_t shards() const;
+
+private:
+    // gerador xorshift por thread
+    static uint64_t random();
+
+    // trava um heap aleatorio e retorna seu indice
+    size_t lockRandom();
+};
+
+// ----------------------------------------------------------------
+
+// construtor
+template <typename T, typename Comparator, int D>
+MultiQueue<T, Comparator, D>::MultiQueue(unsigned threads, unsigned c) {
+    m_count = static_cast<size_t>(threads == 0 ? 1 : threads) * (c == 0 ? 1 : c);
+    if(m_count < 2) {
+        m_count = 2;
+    }
+    m_shards.reset(new Shard[m_count]);
+    m_size = 0;
+}
+
+// insere um elemento em um heap aleatorio
+template <typename T, typename Comparator, int D>
+void MultiQueue<T, Comparator, D>::push(const T& element) {
+    size_t i = lockRandom();
+    m_shards[i].heap.push(element);
+    m_shards[i].lock.unlock();
+    m_size.fetch_add(1, std::memory_order_relaxed);
+}
+
+// insere um elemento em um heap aleatorio movendo-o
+template <typename T, typename Comparator, int D>
+void MultiQueue<T, Comparator, D>::push(T&& element) {
+    size_t i = lockRandom();
+    m_shards[i].heap.push(std::move(element));
+    m_shards[i].lock.unlock();
+    m_size.fetch_add(1, std::memory_order_relaxed);
+}
+
+// sorteia dois heaps, trava os dois com try_lock e remove do que tiver o
+// topo mais prioritario; se os dois estao vazios varre todos os heaps
+template <typename T, typename Comparator, int D>
+bool MultiQueue<T, Comparator, D>::try_pop(T& out) {
+    for(int attempt = 0; attempt < 8; attempt++) {
+        size_t i = random() % m_count;
+        size_t j = random() % m_count;
+        if(i == j) {
+            j = (j + 1) % m_count;
+        }
+        if(!m_shards[i].lock.try_lock()) {
+            continue;
+        }
+        if(!m_shards[j].lock.try_lock()) {
+            m_shards[i].lock.unlock();
+            continue;
+        }
+        Pq<T, Comparator, D>& a = m_shards[i].heap;
+        Pq<T, Comparator, D>& b = m_shards[j].heap;
+        Pq<T, Comparator, D>* best = nullptr;
+        if(!a.empty() && (b.empty() || !compara(a.top(), b.top()))) {
+            best = &a;
+        } else if(!b.empty()) {
+            best = &b;
+        }
+        if(best != nullptr) {
+            out = best->pop();
+        }
+        m_shards[j].lock.unlock();
+        m_shards[i].lock.unlock();
+        if(best != nullptr) {
+            m_size.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+        if(m_size.load(std::memory_order_relaxed) <= 0) {
+            break;
+        }
+    }
+    // os sorteios falharam: procura qualquer heap com elementos
+    size_t start = random() % m_count;
+    for(size_t k = 0; k < m_count; k++) {
+        Shard& s = m_shards[(start + k) % m_count];
+        std::lock_guard<std::mutex> guard(s.lock);
+        if(!s.heap.empty()) {
+            out = s.heap.pop();
+            m_size.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+// retorna o número (aproximado) de elementos na fila
+template <typename T, typename Comparator, int D>
+size_t MultiQueue<T, Comparator, D>::size() const {
+    long n = m_size.load(std::memory_order_relaxed);
+    return n < 0 ? 0 : static_cast<size_t>(n);
+}
+
+// retorna true se a fila (aproximadamente) esta vazia
+template <typename T, typename Comparator, int D>
+bool MultiQueue<T, Comparator, D>::empty() const {
+    return size() == 0;
+}
+
+// retorna o numero de heaps
+template <typename T, typename Comparator, int D>
+size_t MultiQueue<T, Comparator, D>::shards() const {
+    return m_count;
+}
+
+// xorshift64* com estado por thread, semeado pelo id da thread
+template <typename T, typename Comparator, int D>
+uint64_t MultiQueue<T, Comparator, D>::random() {
+    thread_local uint64_t state =
+        std::hash<std::thread::id>()(std::this_thread::get_id()) * 0x9E3779B97F4A7C15ull | 1;
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1Dull;
+}
+
+// tenta travar heaps aleatorios ate conseguir um
+template <typename T, typename Comparator, int D>
+size_t MultiQueue<T, Comparator, D>::lockRandom() {
+    for(size_t tries = 1; ; tries++) {
+        size_t i = random() % m_count;
+        if(m_shards[i].lock.try_lock()) {
+            return i;
+        }
+        if(tries % m_count == 0) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+#endif
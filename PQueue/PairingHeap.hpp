@@ -0,0 +1,281 @@
+#ifndef PAIRINGHEAP_HPP
+#define PAIRINGHEAP_HPP
+#include <stdexcept>
+#include <vector>
+#include <utility>
+#include <cstddef>
+
+// Pairing heap com handles: push e decrease_key em O(1), pop em O(log n)
+// amortizado. Usa o mesmo Comparator de Pq (std::less -> maior elemento
+// no topo) e a mesma interface (push, top, pop, size, empty), entao pode
+// substituir Pq por parametro de template.
+//
+// Cada no aponta para o primeiro filho, para o proximo irmao e para prev
+// (o irmao anterior, ou o pai se for o primeiro filho), o que permite
+// desligar uma subarvore em O(1). O handle devolvido por push eh valido ate
+// o elemento sair da fila.
+template <typename T, typename Comparator>
+class PairingHeap {
+public:
+    struct Node;
+    using Handle = Node*;
+
+    struct Node {
+        T value;
+        Node* child;   // primeiro filho
+        Node* sibling; // proximo irmao
+        Node* prev;    // irmao anterior ou pai
+
+        template <typename U>
+        explicit Node(U&& v) : value(std::forward<U>(v)) {
+            child = nullptr;
+            sibling = nullptr;
+            prev = nullptr;
+        }
+    };
+
+private:
+    Node* m_root;                // raiz
+    size_t m_size;               // numero de elementos
+    std::vector<Node*> m_scratch; // filhos da raiz durante o pop
+    Comparator compara;
+
+public:
+    // Construtor
+    PairingHeap();
+
+    // Destrutor
+    ~PairingHeap();
+
+    PairingHeap(const PairingHeap&) = delete;
+    PairingHeap& operator=(const PairingHeap&) = delete;
+
+    // retorna o número de elementos na fila
+    size_t size() const;
+
+    // retorna true se e somente se a fila esta vazia
+    bool empty() const;
+
+    // retorna o valor do elemento prioritario
+    const T& top() const;
+
+    // remove o elemento prioritario e o retorna
+    T pop();
+
+    // insere um elemento na fila e retorna seu handle
+    Handle push(const T& element);
+
+    // insere um elemento na fila movendo-o e retorna seu handle
+    Handle push(T&& element);
+
+    // torna o elemento h mais prioritario (newPriority nao pode ser
+    // menos prioritario que o valor atual) em O(1)
+    void decrease_key(Handle h, const T& newPriority);
+
+    // remove o elemento h da fila
+    void erase(Handle h);
+
+    // esvazia a fila; todos os handles deixam de ser validos
+    void clear();
+
+private:
+    // une duas arvores: a de raiz menos prioritaria vira filha da outra
+    Node* meld(Node* a, Node* b);
+
+    // desliga a subarvore de h do pai e dos irmaos
+    void detach(Node* h);
+
+    // une a lista de irmaos que comeca em first em duas passadas
+    Node* combine(Node* first);
+
+    // cria um no e o une a raiz
+    template <typename U>
+    Handle insert(U&& element);
+};
+
+// ----------------------------------------------------------------
+
+// construtor default
+template <typename T, typename Comparator>
+PairingHeap<T, Comparator>::PairingHeap() {
+    m_root = nullptr;
+    m_size = 0;
+}
+
+// destrutor
+template <typename T, typename Comparator>
+PairingHeap<T, Comparator>::~PairingHeap() {
+    clear();
+}
+
+// retorna o número de elementos na fila
+template <typename T, typename Comparator>
+size_t PairingHeap<T, Comparator>::size() const {
+    return m_size;
+}
+
+// retorna true se e somente se a fila esta vazia
+template <typename T, typename Comparator>
+bool PairingHeap<T, Comparator>::empty() const {
+    return m_size == 0;
+}
+
+// retorna o valor do elemento prioritario
+template <typename T, typename Comparator>
+const T& PairingHeap<T, Comparator>::top() const {
+    if(empty()) {
+        throw std::underflow_error("empty queue");
+    }
+    return m_root->value;
+}
+
+// remove a raiz e une seus filhos
+template <typename T, typename Comparator>
+T PairingHeap<T, Comparator>::pop() {
+    if(empty()) {
+        throw std::underflow_error("empty queue");
+    }
+    Node* old = m_root;
+    T element = std::move(old->value);
+    m_root = combine(old->child);
+    delete old;
+    m_size--;
+    return element;
+}
+
+// insere um elemento na fila e retorna seu handle
+template <typename T, typename Comparator>
+typename PairingHeap<T, Comparator>::Handle PairingHeap<T, Comparator>::push(const T& element) {
+    return insert(element);
+}
+
+// insere um elemento na fila movendo-o e retorna seu handle
+template <typename T, typename Comparator>
+typename PairingHeap<T, Comparator>::Handle PairingHeap<T, Comparator>::push(T&& element) {
+    return insert(std::move(element));
+}
+
+// troca o valor de h e, se ele nao eh a raiz, desliga sua subarvore e
+// a une de novo a raiz
+template <typename T, typename Comparator>
+void PairingHeap<T, Comparator>::decrease_key(Handle h, const T& newPriority) {
+    if(compara(newPriority, h->value)) {
+        throw std::underflow_error("Invalid key");
+    }
+    h->value = newPriority;
+    if(h != m_root) {
+        detach(h);
+        m_root = meld(m_root, h);
+    }
+}
+
+// remove h: seus filhos sao unidos e voltam para a raiz
+template <typename T, typename Comparator>
+void PairingHeap<T, Comparator>::erase(Handle h) {
+    if(h == m_root) {
+        pop();
+        return;
+    }
+    detach(h);
+    Node* sub = combine(h->child);
+    delete h;
+    m_size--;
+    m_root = meld(m_root, sub);
+}
+
+// esvazia a fila sem recursao: os filhos de cada no sao
+// empilhados antes de ele ser liberado
+template <typename T, typename Comparator>
+void PairingHeap<T, Comparator>::clear() {
+    std::vector<Node*> stack;
+    if(m_root != nullptr) {
+        stack.push_back(m_root);
+    }
+    while(!stack.empty()) {
+        Node* node = stack.back();
+        stack.pop_back();
+        if(node->child != nullptr) {
+            stack.push_back(node->child);
+        }
+        if(node->sibling != nullptr) {
+            stack.push_back(node->sibling);
+        }
+        delete node;
+    }
+    m_root = nullptr;
+    m_size = 0;
+}
+
+// une duas arvores sem irmaos
+template <typename T, typename Comparator>
+typename PairingHeap<T, Comparator>::Node* PairingHeap<T, Comparator>::meld(Node* a, Node* b) {
+    if(a == nullptr) {
+        return b;
+    }
+    if(b == nullptr) {
+        return a;
+    }
+    if(compara(a->value, b->value)) {
+        std::swap(a, b);
+    }
+    // b vira o primeiro filho de a
+    b->prev = a;
+    b->sibling = a->child;
+    if(a->child != nullptr) {
+        a->child->prev = b;
+    }
+    a->child = b;
+    a->sibling = nullptr;
+    a->prev = nullptr;
+    return a;
+}
+
+// desliga a subarvore de h
+template <typename T, typename Comparator>
+void PairingHeap<T, Comparator>::detach(Node* h) {
+    if(h->prev->child == h) {
+        h->prev->child = h->sibling;
+    } else {
+        h->prev->sibling = h->sibling;
+    }
+    if(h->sibling != nullptr) {
+        h->sibling->prev = h->prev;
+    }
+    h->sibling = nullptr;
+    h->prev = nullptr;
+}
+
+// une os irmaos em duas passadas: primeiro em pares da esquerda para a
+// direita, depois os pares da direita para a esquerda
+template <typename T, typename Comparator>
+typename PairingHeap<T, Comparator>::Node* PairingHeap<T, Comparator>::combine(Node* first) {
+    m_scratch.clear();
+    while(first != nullptr) {
+        Node* a = first;
+        Node* b = a->sibling;
+        first = b != nullptr ? b->sibling : nullptr;
+        a->sibling = nullptr;
+        if(b != nullptr) {
+            b->sibling = nullptr;
+        }
+        m_scratch.push_back(meld(a, b));
+    }
+    Node* root = nullptr;
+    while(!m_scratch.empty()) {
+        root = meld(m_scratch.back(), root);
+        m_scratch.pop_back();
+    }
+    return root;
+}
+
+// cria um no e o une a raiz
+template <typename T, typename Comparator>
+template <typename U>
+typename PairingHeap<T, Comparator>::Handle PairingHeap<T, Comparator>::insert(U&& element) {
+    Node* node = new Node(std::forward<U>(element));
+    m_root = meld(m_root, node);
+    m_size++;
+    return node;
+}
+
+#endif
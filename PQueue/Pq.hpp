@@ -2,12 +2,135 @@
 #define PQ_HPP
 #include <stdexcept>
 #include <vector>
+#include <utility>
+#include <new>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <iterator>
+#include <algorithm>
+#ifdef __SSE4_1__
+#include <smmintrin.h>
+#endif
 
-template <typename T, typename Comparator>
+// tamanho de uma linha de cache
+const size_t PQ_CACHE_LINE = 64;
+
+// alocador que alinha o buffer do heap ao inicio de uma linha de cache
+template <typename T, size_t Align = PQ_CACHE_LINE>
+struct AlignedAllocator {
+    using value_type = T;
+    template <typename U> struct rebind { using other = AlignedAllocator<U, Align>; };
+
+    AlignedAllocator() = default;
+    template <typename U> AlignedAllocator(const AlignedAllocator<U, Align>&) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Align)));
+    }
+    void deallocate(T* p, size_t) {
+        ::operator delete(p, std::align_val_t(Align));
+    }
+    template <typename U> bool operator==(const AlignedAllocator<U, Align>&) const { return true; }
+    template <typename U> bool operator!=(const AlignedAllocator<U, Align>&) const { return false; }
+};
+
+namespace pq_simd {
+    // retorna a posicao (0..D-1) do maior (Max) ou menor elemento de um grupo
+    // completo de D filhos, ou -1 se nao ha versao vetorizada para o tipo
+    // (ou, para float, se o grupo tem NaN)
+    template <typename T, int D, bool Max>
+    inline int best(const T*) { return -1; }
+
+#ifdef __SSE4_1__
+    // reduz v ao maximo/minimo nas quatro posicoes
+    template <bool Max>
+    inline __m128i reduce(__m128i v) {
+        __m128i s = _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+        v = Max ? _mm_max_epi32(v, s) : _mm_min_epi32(v, s);
+        s = _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+        return Max ? _mm_max_epi32(v, s) : _mm_min_epi32(v, s);
+    }
+    template <bool Max>
+    inline __m128 reduce(__m128 v) {
+        __m128 s = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+        v = Max ? _mm_max_ps(v, s) : _mm_min_ps(v, s);
+        s = _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2));
+        return Max ? _mm_max_ps(v, s) : _mm_min_ps(v, s);
+    }
+    inline int mask(__m128i v, __m128i m) {
+        return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(v, m)));
+    }
+    inline int mask(__m128 v, __m128 m) {
+        return _mm_movemask_ps(_mm_cmpeq_ps(v, m));
+    }
+
+    template <> inline int best<int, 4, true>(const int* p) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        return __builtin_ctz(mask(v, reduce<true>(v)));
+    }
+    template <> inline int best<int, 4, false>(const int* p) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        return __builtin_ctz(mask(v, reduce<false>(v)));
+    }
+    template <> inline int best<int, 8, true>(const int* p) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 4));
+        __m128i m = reduce<true>(_mm_max_epi32(a, b));
+        return __builtin_ctz(mask(a, m) | (mask(b, m) << 4));
+    }
+    template <> inline int best<int, 8, false>(const int* p) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 4));
+        __m128i m = reduce<false>(_mm_min_epi32(a, b));
+        return __builtin_ctz(mask(a, m) | (mask(b, m) << 4));
+    }
+    template <> inline int best<float, 4, true>(const float* p) {
+        __m128 v = _mm_loadu_ps(p);
+        int m = mask(v, reduce<true>(v));
+        return m ? __builtin_ctz(m) : -1;
+    }
+    template <> inline int best<float, 4, false>(const float* p) {
+        __m128 v = _mm_loadu_ps(p);
+        int m = mask(v, reduce<false>(v));
+        return m ? __builtin_ctz(m) : -1;
+    }
+    template <> inline int best<float, 8, true>(const float* p) {
+        __m128 a = _mm_loadu_ps(p);
+        __m128 b = _mm_loadu_ps(p + 4);
+        __m128 m = reduce<true>(_mm_max_ps(a, b));
+        int bits = mask(a, m) | (mask(b, m) << 4);
+        return bits ? __builtin_ctz(bits) : -1;
+    }
+    template <> inline int best<float, 8, false>(const float* p) {
+        __m128 a = _mm_loadu_ps(p);
+        __m128 b = _mm_loadu_ps(p + 4);
+        __m128 m = reduce<false>(_mm_min_ps(a, b));
+        int bits = mask(a, m) | (mask(b, m) << 4);
+        return bits ? __builtin_ctz(bits) : -1;
+    }
+#endif
+}
+
+// Heap d-ario (D = 2, 4, 8...). A raiz fica na posicao D-1 do vetor e os
+// filhos de p ocupam as posicoes D*(p-D+2) ... D*(p-D+2)+D-1, entao cada grupo
+// de irmaos comeca em um multiplo de D; com o buffer alinhado a linha de cache,
+// os D filhos de um no ficam na mesma linha quando D*sizeof(T) <= 64.
+// Para D = 2 eh exatamente o heap 1-indexado classico.
+template <typename T, typename Comparator, int D = 2>
 class Pq {
+    static_assert(D >= 2, "a aridade do heap deve ser pelo menos 2");
+
+    // D = 2 usa std::vector comum para poder adotar vetores sem copia
+    using Storage = typename std::conditional<D == 2, std::vector<T>,
+        std::vector<T, AlignedAllocator<T>>>::type;
+
+    // posicao da raiz no vetor
+    static constexpr int ROOT = D - 1;
+
 private:
     int m_heapSize;         // numero de elementos no heap
-    std::vector<T> m_vec;   // heap
+    Storage m_vec;          // heap
     Comparator compara;
 
 public:
@@ -17,6 +140,9 @@ public:
     // Contrutor cria um heap a partir de um vector previo
     Pq(const std::vector<T>& v);
 
+    // Contrutor que adota os elementos de v (sem copia) e cria o heap em O(n)
+    Pq(std::vector<T>&& v);
+
     // retorna o número de elementos na fila
     int size() const;
 
@@ -26,20 +152,61 @@ public:
     // retorna o valor do elemento prioritario
     const T& top() const;
 
-    // remove o elemento prioritario
-    void pop();
+    // remove o elemento prioritario e o retorna
+    T pop();
 
     // insere um elemento na fila
     void push(const T& element);
 
-    //aumenta valor de uma chave e a reajusta
-    void increaseKey(int i, int newKey);
+    // insere um elemento na fila movendo-o
+    void push(T&& element);
+
+    // constroi um elemento direto no heap a partir dos argumentos
+    template <typename... Args>
+    void emplace(Args&&... args);
+
+    // insere os elementos de [begin, end): lotes pequenos sobem um a um,
+    // lotes grandes em relacao a fila reconstroem o heap inteiro em O(n)
+    template <typename InputIt>
+    void push_range(InputIt begin, InputIt end);
 
-    //diminui valor de uma chave e a reajusta
-    void decreaseKey(int i, int newKey);
+    // move todos os elementos de other para esta fila, deixando other vazia
+    void merge(Pq&& other);
+
+    // remove os k elementos mais prioritarios (ou todos, se k >= size())
+    // e os escreve em out em ordem de prioridade; retorna out
+    template <typename OutputIt>
+    OutputIt pop_k(int k, OutputIt out);
+
+    //torna a chave da posicao i mais prioritaria e a reajusta
+    //(i eh a posicao 1-indexada do elemento no heap; para acompanhar um
+    //elemento enquanto ele se move use IndexedPq)
+    void increaseKey(int i, const T& newKey);
+
+    //torna a chave da posicao i menos prioritaria e a reajusta
+    void decreaseKey(int i, const T& newKey);
 
 private:
-    // recebe como entrada um indice e faz 
+    // posicao do primeiro filho de p
+    static int firstChild(int p) { return D * (p - D + 2); }
+
+    // posicao do pai de c
+    static int parent(int c) { return c / D + D - 2; }
+
+    // posicao do ultimo elemento do heap
+    int last() const { return ROOT + m_heapSize - 1; }
+
+    // posicao do filho mais prioritario entre first e first+count-1
+    int bestChild(int first, int count) const;
+
+    // floor(log_D(n)), altura aproximada de um heap com n elementos
+    static int height(int n);
+
+    // pop que leva o "buraco" da raiz ate uma folha sem comparar com o
+    // elemento que desce, e so entao o faz subir (heap de Floyd)
+    T popBottomUp();
+
+    // recebe como entrada um indice e faz
     // o elemento m_vec[index] descer no heap
     void fixDown(int index);
 
@@ -49,22 +216,23 @@ private:
 
     // rearranja os elementos do vector m_vec de modo
     // a obter um heap
-    void buildAbsoluteHeap(); 
+    void buildAbsoluteHeap();
 };
 
 // ----------------------------------------------------------------
 
-// construtor default
-template <typename T, typename Comparator>
-Pq<T, Comparator>::Pq() {
+// construtor default: as posicoes antes da raiz nao sao usadas
+template <typename T, typename Comparator, int D>
+Pq<T, Comparator, D>::Pq() {
     m_heapSize = 0;
-    m_vec.push_back(T());
+    m_vec.resize(ROOT);
 }
 
 // Contrutor cria um heap a partir de um vector prévio
-template <typename T, typename Comparator>
-Pq<T, Comparator>::Pq(const std::vector<T>& v) : Pq(){
+template <typename T, typename Comparator, int D>
+Pq<T, Comparator, D>::Pq(const std::vector<T>& v) : Pq(){
     // copia os elementos de v para m_vec
+    m_vec.reserve(ROOT + v.size());
     for(const T& element : v) {
         m_vec.push_back(element);
     }
@@ -74,60 +242,190 @@ Pq<T, Comparator>::Pq(const std::vector<T>& v) : Pq(){
     buildAbsoluteHeap();
 }
 
+// Contrutor que adota os elementos de v: para D = 2 o primeiro elemento vai
+// para o fim, a posicao 0 (nao usada pelo heap) fica como buraco e o buffer
+// eh movido para m_vec sem deslocar os demais; para D > 2 os elementos sao
+// movidos para o buffer alinhado
+template <typename T, typename Comparator, int D>
+Pq<T, Comparator, D>::Pq(std::vector<T>&& v) {
+    m_heapSize = v.size();
+    if constexpr (std::is_same<Storage, std::vector<T>>::value) {
+        if(v.empty()) {
+            v.resize(ROOT);
+        } else {
+            v.push_back(std::move(v[0]));
+        }
+        m_vec = std::move(v);
+    } else {
+        m_vec.reserve(ROOT + v.size());
+        m_vec.resize(ROOT);
+        for(T& element : v) {
+            m_vec.push_back(std::move(element));
+        }
+        v.clear();
+    }
+    buildAbsoluteHeap();
+}
+
 // retorna o número de elementos na fila
-template <typename T, typename Comparator>
-int Pq<T, Comparator>::size() const {
+template <typename T, typename Comparator, int D>
+int Pq<T, Comparator, D>::size() const {
     return m_heapSize;
 }
 
 // retorna true se e somente se a fila esta vazia
-template <typename T, typename Comparator>
-bool Pq<T, Comparator>::empty() const {
+template <typename T, typename Comparator, int D>
+bool Pq<T, Comparator, D>::empty() const {
     return m_heapSize == 0;
 }
 
 // retorna o valor do elemento prioritario
-template <typename T, typename Comparator>
-const T& Pq<T, Comparator>::top() const {
+template <typename T, typename Comparator, int D>
+const T& Pq<T, Comparator, D>::top() const {
     if(empty()) {
         throw std::underflow_error("empty queue");
     }
-    return m_vec[1];
+    return m_vec[ROOT];
 }
 
 // insere um elemento na fila
-template <typename T, typename Comparator>
-void Pq<T, Comparator>::push(const T& element) {
+template <typename T, typename Comparator, int D>
+void Pq<T, Comparator, D>::push(const T& element) {
     m_vec.push_back(element);
     m_heapSize++;
-    fixUp(m_heapSize);
+    fixUp(last());
 }
 
-// remove o elemento prioritario
-template <typename T, typename Comparator>
-void Pq<T, Comparator>::pop() {
+// insere um elemento na fila movendo-o
+template <typename T, typename Comparator, int D>
+void Pq<T, Comparator, D>::push(T&& element) {
+    m_vec.push_back(std::move(element));
+    m_heapSize++;
+    fixUp(last());
+}
+
+// constroi um elemento direto no fim do heap e o faz subir
+template <typename T, typename Comparator, int D>
+template <typename... Args>
+void Pq<T, Comparator, D>::emplace(Args&&... args) {
+    m_vec.emplace_back(std::forward<Args>(args)...);
+    m_heapSize++;
+    fixUp(last());
+}
+
+// remove o elemento prioritario e o retorna:
+// o ultimo elemento ocupa a raiz e desce no heap
+template <typename T, typename Comparator, int D>
+T Pq<T, Comparator, D>::pop() {
     if(empty()) {
         throw std::underflow_error("empty queue");
     }
-    m_vec[1] = m_vec[m_heapSize];
+    T element = std::move(m_vec[ROOT]);
+    if(m_heapSize > 1) {
+        m_vec[ROOT] = std::move(m_vec[last()]);
+    }
+    m_vec.pop_back();
     m_heapSize--;
-    fixDown(1);
+    if(m_heapSize > 1) {
+        fixDown(ROOT);
+    }
+    return element;
+}
+
+// insere os elementos de [begin, end) no fim do vetor; se o lote eh grande
+// (m * altura >= n + m) sai mais barato reconstruir o heap todo com
+// buildAbsoluteHeap do que fazer cada elemento subir
+template <typename T, typename Comparator, int D>
+template <typename InputIt>
+void Pq<T, Comparator, D>::push_range(InputIt begin, InputIt end) {
+    int first = m_heapSize;
+    for(; begin != end; ++begin) {
+        m_vec.push_back(*begin);
+    }
+    int batch = static_cast<int>(m_vec.size()) - ROOT - first;
+    m_heapSize = first + batch;
+    if(batch * height(m_heapSize) >= m_heapSize) {
+        buildAbsoluteHeap();
+    } else {
+        for(int i = ROOT + first; i <= last(); i++) {
+            fixUp(i);
+        }
+    }
+}
+
+// move os elementos de other para esta fila; o menor dos dois heaps eh
+// acrescentado ao maior. Juntar a fila com ela mesma nao faz nada
+template <typename T, typename Comparator, int D>
+void Pq<T, Comparator, D>::merge(Pq&& other) {
+    if(&other == this) {
+        return;
+    }
+    if(other.m_heapSize > m_heapSize) {
+        std::swap(m_vec, other.m_vec);
+        std::swap(m_heapSize, other.m_heapSize);
+    }
+    push_range(std::make_move_iterator(other.m_vec.begin() + ROOT),
+               std::make_move_iterator(other.m_vec.end()));
+    other.m_vec.resize(ROOT);
+    other.m_heapSize = 0;
+}
+
+// remove os k elementos mais prioritarios e os escreve em out.
+// Para k pequeno faz k pops de Floyd; para k grande (k * altura > n)
+// separa os k primeiros com nth_element, ordena so esses e reconstroi
+// o heap com o resto
+template <typename T, typename Comparator, int D>
+template <typename OutputIt>
+OutputIt Pq<T, Comparator, D>::pop_k(int k, OutputIt out) {
+    if(k > m_heapSize) {
+        k = m_heapSize;
+    }
+    if(k <= 0) {
+        return out;
+    }
+    if(static_cast<long long>(k) * height(m_heapSize) <= m_heapSize) {
+        for(int i = 0; i < k; i++) {
+            *out = popBottomUp();
+            ++out;
+        }
+        return out;
+    }
+    auto first = m_vec.begin() + ROOT;
+    auto middle = first + k;
+    auto priority = [this](const T& a, const T& b) { return compara(b, a); };
+    if(k < m_heapSize) {
+        std::nth_element(first, middle, m_vec.end(), priority);
+    }
+    std::sort(first, middle, priority);
+    out = std::move(first, middle, out);
+    m_vec.erase(first, middle);
+    m_heapSize -= k;
+    buildAbsoluteHeap();
+    return out;
 }
 
-//aumenta valor de uma chave e a reajusta
-template <typename T, typename Comparator>
-void Pq<T, Comparator>::increaseKey(int i, int newKey) {
-    if(!compara(newKey, m_vec[i])){
+//torna a chave da posicao i mais prioritaria e a faz subir
+template <typename T, typename Comparator, int D>
+void Pq<T, Comparator, D>::increaseKey(int i, const T& newKey) {
+    if(i < 1 || i > m_heapSize) {
+        throw std::out_of_range("index out of range");
+    }
+    i += ROOT - 1;
+    if(compara(newKey, m_vec[i])){
         throw std::underflow_error("Invalid key");
     }
     m_vec[i] = newKey;
     fixUp(i);
 }
 
-//diminui valor de uma chave e a reajusta
-template <typename T, typename Comparator>
-void Pq<T, Comparator>::decreaseKey(int i, int newKey) {
-    if(compara(newKey, m_vec[i])){
+//torna a chave da posicao i menos prioritaria e a faz descer
+template <typename T, typename Comparator, int D>
+void Pq<T, Comparator, D>::decreaseKey(int i, const T& newKey) {
+    if(i < 1 || i > m_heapSize) {
+        throw std::out_of_range("index out of range");
+    }
+    i += ROOT - 1;
+    if(compara(m_vec[i], newKey)){
         throw std::underflow_error("Invalid key");
     }
     m_vec[i] = newKey;
@@ -135,46 +433,110 @@ void Pq<T, Comparator>::decreaseKey(int i, int newKey) {
 }
 
 // recebe como entrada um indice e faz
-// o elemento m_vec[index] subir no heap
-template <typename T, typename Comparator>
-void Pq<T, Comparator>::fixUp(int index) {
-    while(index != 1 && compara(m_vec[index/2],m_vec[index])) {        
-        T aux = m_vec[index];
-        m_vec[index] = m_vec[index/2];
-        m_vec[index/2] = aux;
-        index = index/2;
-    }
-}
-
-// recebe como entrada um indice e faz 
-// o elemento m_vec[index] descer no heap
-template <typename T, typename Comparator>
-void Pq<T, Comparator>::fixDown(int index) {
-    while(2*index <= m_heapSize) {
-        int ileft = 2*index;           
-        int iright = ileft+1;
-        int ipriority = index;
-        if(compara(m_vec[index], m_vec[ileft]))
-            ipriority = ileft;
-        if(iright <= m_heapSize && compara(m_vec[ipriority], m_vec[iright]))
-            ipriority = iright;
-        if(ipriority != index) {
-           Kaux = m_vec[index];
-            m_vec[index] = m_vec[ipriority];
-            m_vec[ipriority] = aux;
-            index = ipriority;
-        } 
-        else break;
+// o elemento m_vec[index] subir no heap:
+// o elemento sai do vetor, os pais menos prioritarios descem
+// para o "buraco" e ao final o elemento eh colocado na posicao livre
+template <typename T, typename Comparator, int D>
+void Pq<T, Comparator, D>::fixUp(int index) {
+    T element = std::move(m_vec[index]);
+    while(index != ROOT && compara(m_vec[parent(index)], element)) {
+        m_vec[index] = std::move(m_vec[parent(index)]);
+        index = parent(index);
+    }
+    m_vec[index] = std::move(element);
+}
+
+// retorna a posicao do filho mais prioritario entre first e first+count-1;
+// com o grupo completo e T aritmetico comparado por std::less/std::greater,
+// a escolha eh feita com instrucoes SIMD
+template <typename T, typename Comparator, int D>
+int Pq<T, Comparator, D>::bestChild(int first, int count) const {
+    constexpr bool isMax = std::is_same<Comparator, std::less<T>>::value;
+    constexpr bool isMin = std::is_same<Comparator, std::greater<T>>::value;
+    if constexpr (isMax || isMin) {
+        if(count == D) {
+            int i = pq_simd::best<T, D, isMax>(&m_vec[first]);
+            if(i >= 0) {
+                return first + i;
+            }
+        }
+    }
+    int ipriority = first;
+    for(int c = first + 1; c < first + count; c++) {
+        if(compara(m_vec[ipriority], m_vec[c]))
+            ipriority = c;
+    }
+    return ipriority;
+}
+
+// floor(log_D(n)), com minimo 1
+template <typename T, typename Comparator, int D>
+int Pq<T, Comparator, D>::height(int n) {
+    int h = 1;
+    while(n >= D * D) {
+        n /= D;
+        h++;
+    }
+    return h;
+}
+
+// remove a raiz descendo o "buraco" sempre pelo filho mais prioritario ate
+// uma folha; o ultimo elemento ocupa esse buraco e sobe. Como o ultimo
+// elemento costuma pertencer ao fundo do heap, isso evita a comparacao
+// extra por nivel que o fixDown faz
+template <typename T, typename Comparator, int D>
+T Pq<T, Comparator, D>::popBottomUp() {
+    T element = std::move(m_vec[ROOT]);
+    int ilast = last();
+    int hole = ROOT;
+    while(firstChild(hole) <= ilast) {
+        int first = firstChild(hole);
+        int count = ilast - first + 1 < D ? ilast - first + 1 : D;
+        int ipriority = bestChild(first, count);
+        m_vec[hole] = std::move(m_vec[ipriority]);
+        hole = ipriority;
+    }
+    if(hole != ilast) {
+        m_vec[hole] = std::move(m_vec[ilast]);
+    }
+    m_vec.pop_back();
+    m_heapSize--;
+    if(hole != ilast) {
+        fixUp(hole);
+    }
+    return element;
+}
+
+// recebe como entrada um indice e faz
+// o elemento m_vec[index] descer no heap:
+// o filho mais prioritario sobe para o "buraco" ate que
+// o elemento seja mais prioritario que todos os filhos
+template <typename T, typename Comparator, int D>
+void Pq<T, Comparator, D>::fixDown(int index) {
+    T element = std::move(m_vec[index]);
+    int ilast = last();
+    while(firstChild(index) <= ilast) {
+        int first = firstChild(index);
+        int count = ilast - first + 1 < D ? ilast - first + 1 : D;
+        int ipriority = bestChild(first, count);
+        if(!compara(element, m_vec[ipriority]))
+            break;
+        m_vec[index] = std::move(m_vec[ipriority]);
+        index = ipriority;
     }
+    m_vec[index] = std::move(element);
 }
 
 // rearranja os elementos do vector m_vec de modo a obter um heap absoluto
-template <typename T, typename Comparator>
-void Pq<T, Comparator>::buildAbsoluteHeap() {
-    for(int i = m_vec.size()/2; i >= 1; i--) {
+template <typename T, typename Comparator, int D>
+void Pq<T, Comparator, D>::buildAbsoluteHeap() {
+    if(m_heapSize < 2) {
+        return;
+    }
+    for(int i = parent(last()); i >= ROOT; i--) {
         fixDown(i);
     }
 }
 
 
-#endif
\ No newline at end of file
+#endif
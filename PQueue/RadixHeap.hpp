@@ -0,0 +1,215 @@
+#ifndef RADIXHEAP_HPP
+#define RADIXHEAP_HPP
+#include <stdexcept>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+// chave padrao da RadixHeap: o proprio elemento convertido para uint64_t
+struct RadixKey {
+    template <typename T>
+    uint64_t operator()(const T& element) const {
+        return static_cast<uint64_t>(element);
+    }
+};
+
+// Radix heap monotona (fila de minimo) para chaves inteiras sem sinal.
+//
+// A fila guarda a ultima chave devolvida por pop (m_last) e so aceita
+// chaves >= a ela, o que vale para o Dijkstra e para eventos ordenados no
+// tempo. Um elemento de chave k fica no balde b(k) = numero de bits da
+// posicao mais alta em que k difere de m_last (0 se k == m_last), entao ha
+// 65 baldes. push eh O(1); quando pop encontra o balde 0 vazio, o primeiro
+// balde nao vazio eh redistribuido em baldes menores, e como um elemento so
+// desce de balde, pop custa O(log C) amortizado, com C a maior diferenca
+// entre chaves. top so consulta: procura o menor elemento do primeiro balde
+// nao vazio (e guarda onde ele esta ate o proximo push ou pop), sem mudar
+// m_last nem, portanto, as chaves aceitas.
+//
+// Tem a mesma interface de Pq (push, top, pop, size, empty) para ser
+// trocada por parametro de template; KeyOf extrai a chave de um elemento.
+template <typename T, typename KeyOf = RadixKey>
+class RadixHeap {
+private:
+    static const int BUCKETS = 65;
+
+    std::vector<T> m_bucket[BUCKETS];   // baldes
+    uint64_t m_last;                    // ultima chave devolvida por pop
+    size_t m_size;                      // numero de elementos
+    KeyOf key;                          // extrai a chave de um elemento
+
+    // posicao do menor elemento achada por top (m_topBucket < 0: nao calculada)
+    mutable int m_topBucket;
+    mutable size_t m_topIndex;
+
+public:
+    // Construtor
+    RadixHeap();
+
+    // retorna o número de elementos na fila
+    size_t size() const;
+
+    // retorna true se e somente se a fila esta vazia
+    bool empty() const;
+
+    // retorna o elemento de menor chave
+    const T& top() const;
+
+    // remove o elemento de menor chave e o retorna
+    T pop();
+
+    // insere um elemento; lanca invalid_argument se sua chave for menor
+    // que a ultima chave devolvida por pop
+    void push(const T& element);
+
+    // insere um elemento movendo-o
+    void push(T&& element);
+
+    // esvazia a fila e volta a aceitar qualquer chave
+    void clear();
+
+private:
+    // balde de uma chave em relacao a m_last
+    int bucketOf(uint64_t k) const;
+
+    // coloca um elemento ja validado no seu balde
+    template <typename U>
+    void insert(U&& element);
+
+    // se o balde 0 esta vazio, redistribui o primeiro balde nao vazio
+    void refill();
+};
+
+// ----------------------------------------------------------------
+
+// construtor default
+template <typename T, typename KeyOf>
+RadixHeap<T, KeyOf>::RadixHeap() {
+    m_last = 0;
+    m_size = 0;
+    m_topBucket = -1;
+}
+
+// retorna o número de elementos na fila
+template <typename T, typename KeyOf>
+size_t RadixHeap<T, KeyOf>::size() const {
+    return m_size;
+}
+
+// retorna true se e somente se a fila esta vazia
+template <typename T, typename KeyOf>
+bool RadixHeap<T, KeyOf>::empty() const {
+    return m_size == 0;
+}
+
+// retorna o elemento de menor chave: qualquer um do balde 0 ou, se ele
+// estiver vazio, o menor do primeiro balde nao vazio
+template <typename T, typename KeyOf>
+const T& RadixHeap<T, KeyOf>::top() const {
+    if(empty()) {
+        throw std::underflow_error("empty queue");
+    }
+    if(!m_bucket[0].empty()) {
+        return m_bucket[0].back();
+    }
+    if(m_topBucket < 0) {
+        int i = 1;
+        while(m_bucket[i].empty()) {
+            i++;
+        }
+        size_t best = 0;
+        for(size_t j = 1; j < m_bucket[i].size(); j++) {
+            if(key(m_bucket[i][j]) < key(m_bucket[i][best])) {
+                best = j;
+            }
+        }
+        m_topBucket = i;
+        m_topIndex = best;
+    }
+    return m_bucket[m_topBucket][m_topIndex];
+}
+
+// remove o elemento de menor chave e o retorna
+template <typename T, typename KeyOf>
+T RadixHeap<T, KeyOf>::pop() {
+    if(empty()) {
+        throw std::underflow_error("empty queue");
+    }
+    refill();
+    T element = std::move(m_bucket[0].back());
+    m_bucket[0].pop_back();
+    m_size--;
+    m_topBucket = -1;
+    return element;
+}
+
+// insere um elemento
+template <typename T, typename KeyOf>
+void RadixHeap<T, KeyOf>::push(const T& element) {
+    insert(element);
+}
+
+// insere um elemento movendo-o
+template <typename T, typename KeyOf>
+void RadixHeap<T, KeyOf>::push(T&& element) {
+    insert(std::move(element));
+}
+
+// esvazia a fila
+template <typename T, typename KeyOf>
+void RadixHeap<T, KeyOf>::clear() {
+    for(int i = 0; i < BUCKETS; i++) {
+        m_bucket[i].clear();
+    }
+    m_last = 0;
+    m_size = 0;
+    m_topBucket = -1;
+}
+
+// balde de k: 0 se k == m_last, senao 1 + indice do bit mais alto de k ^ m_last
+template <typename T, typename KeyOf>
+int RadixHeap<T, KeyOf>::bucketOf(uint64_t k) const {
+    return k == m_last ? 0 : 64 - __builtin_clzll(k ^ m_last);
+}
+
+// valida a chave e coloca o elemento no seu balde
+template <typename T, typename KeyOf>
+template <typename U>
+void RadixHeap<T, KeyOf>::insert(U&& element) {
+    uint64_t k = key(element);
+    if(k < m_last) {
+        throw std::invalid_argument("key smaller than the last returned key");
+    }
+    m_bucket[bucketOf(k)].push_back(std::forward<U>(element));
+    m_size++;
+    m_topBucket = -1;
+}
+
+// move o menor elemento para o balde 0: a menor chave do primeiro balde
+// nao vazio vira m_last e os elementos desse balde sao redistribuidos
+// (todos caem em baldes de indice menor)
+template <typename T, typename KeyOf>
+void RadixHeap<T, KeyOf>::refill() {
+    if(!m_bucket[0].empty() || m_size == 0) {
+        return;
+    }
+    int i = 1;
+    while(m_bucket[i].empty()) {
+        i++;
+    }
+    uint64_t smallest = key(m_bucket[i][0]);
+    for(const T& element : m_bucket[i]) {
+        uint64_t k = key(element);
+        if(k < smallest) {
+            smallest = k;
+        }
+    }
+    m_last = smallest;
+    for(T& element : m_bucket[i]) {
+        m_bucket[bucketOf(key(element))].push_back(std::move(element));
+    }
+    m_bucket[i].clear();
+}
+
+#endif
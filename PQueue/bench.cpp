@@ -0,0 +1,84 @@
+// Compara a MultiQueue com um Pq protegido por um unico mutex.
+// Cada thread alterna push de uma chave aleatoria e pop.
+//
+//   g++ -std=c++17 -O2 -pthread bench.cpp -o bench
+//   ./bench [operacoes por thread] [threads maximo]
+#include "Pq.hpp"
+#include "MultiQueue.hpp"
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <random>
+#include <string>
+#include <functional>
+using namespace std;
+
+// fila unica protegida por um mutex
+class LockedPq {
+private:
+    mutex lock;
+    Pq<long, greater<long>> heap;
+
+public:
+    void push(long x) {
+        lock_guard<mutex> guard(lock);
+        heap.push(x);
+    }
+
+    bool try_pop(long& out) {
+        lock_guard<mutex> guard(lock);
+        if(heap.empty()) {
+            return false;
+        }
+        out = heap.pop();
+        return true;
+    }
+};
+
+// executa ops pares push/pop em cada uma das threads e retorna
+// milhoes de operacoes por segundo
+template <typename Queue>
+double run(Queue& q, int threads, long ops) {
+    // carga inicial para que os pops nao encontrem a fila vazia
+    mt19937_64 rng(42);
+    for(long i = 0; i < 100000; i++) {
+        q.push(rng() % 1000000);
+    }
+    auto start = chrono::steady_clock::now();
+    vector<thread> pool;
+    for(int t = 0; t < threads; t++) {
+        pool.emplace_back([&q, ops, t]() {
+            mt19937_64 local(t + 1);
+            long out;
+            for(long i = 0; i < ops; i++) {
+                q.push(local() % 1000000);
+                q.try_pop(out);
+            }
+        });
+    }
+    for(thread& th : pool) {
+        th.join();
+    }
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    return 2.0 * ops * threads / elapsed.count() / 1e6;
+}
+
+int main(int argc, char* argv[]) {
+    long ops = argc > 1 ? stol(argv[1]) : 500000;
+    int maxThreads = argc > 2 ? stoi(argv[2]) : thread::hardware_concurrency();
+    if(maxThreads < 1) {
+        maxThreads = 1;
+    }
+
+    cout << "threads\tLockedPq (Mops/s)\tMultiQueue (Mops/s)" << endl;
+    for(int threads = 1; threads <= maxThreads; threads *= 2) {
+        LockedPq locked;
+        MultiQueue<long, greater<long>> multi(threads);
+        double a = run(locked, threads, ops);
+        double b = run(multi, threads, ops);
+        cout << threads << "\t" << a << "\t\t\t" << b << endl;
+    }
+    return 0;
+}
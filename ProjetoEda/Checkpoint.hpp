@@ -0,0 +1,344 @@
+/**
+ * @file Checkpoint.hpp
+ * @author Paulo Henrique (phenriquedss@alu.ufc.br)
+ * @brief Snapshot periodico + log de incrementos para retomar uma contagem interrompida
+ * Estrutura de dados avancada - 2025.1
+ * @version 0.1
+ * @date 2025-07-14
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <utility>
+#include <unordered_map>
+#include <thread>
+#include <exception>
+#include <cstring>
+#include <stdexcept>
+
+#include "Snapshot.hpp"
+
+/**
+ * @brief Mantem o estado de uma contagem em tres arquivos, a partir de um prefixo base:
+ *
+ *   base.snap      ultimo snapshot completo (Snapshot.hpp), com a posicao S da entrada
+ *                  e a identidade (tamanho e data de modificacao) do arquivo de entrada
+ *   base.log.prev  lotes escritos antes do snapshot que esta sendo gravado
+ *   base.log       lotes escritos depois dele
+ *
+ * Cada lote do log guarda os incrementos de algumas linhas da entrada e a posicao
+ * da entrada logo apos elas:
+ *
+ *   uint64_t end_offset | uint64_t payload_bytes | uint64_t checksum | payload
+ *   payload = repetido: uint32_t tamanho | bytes da palavra | Value incremento
+ *   checksum = FNV-1a de end_offset, payload_bytes e payload
+ *
+ * Um lote so eh aplicado se estiver completo e com o checksum certo, entao uma
+ * queda no meio de uma escrita perde no maximo as linhas desse lote, que sao lidas
+ * de novo ao retomar.
+ *
+ * O snapshot eh gravado por uma thread em segundo plano sobre uma copia congelada
+ * dos pares, entao a contagem continua enquanto ele eh escrito.
+ *
+ * @tparam Value tipo das contagens
+ */
+template <typename Value>
+class Checkpoint {
+public:
+    /**
+     * @brief Cria o checkpoint com os arquivos base.snap, base.log e base.log.prev.
+     *
+     * @param base := prefixo dos arquivos.
+     */
+    explicit Checkpoint(const std::string& base) {
+        m_snap = base + ".snap";
+        m_log = base + ".log";
+        m_prev = base + ".log.prev";
+        m_file = nullptr;
+        m_failed = false;
+        m_source = snapshot::Source{0, 0};
+    }
+
+    ~Checkpoint() {
+        if(m_writer.joinable()) {
+            m_writer.join();
+        }
+        if(m_file != nullptr) {
+            std::fclose(m_file);
+        }
+    }
+
+    Checkpoint(const Checkpoint&) = delete;
+    Checkpoint& operator=(const Checkpoint&) = delete;
+
+    /**
+     * @brief Carrega em dict o ultimo snapshot e reaplica os lotes completos dos logs.
+     * Retorna a posicao da entrada a partir da qual a leitura deve continuar
+     * (0 se nao havia checkpoint). Nada eh gravado: start() deve ser chamado
+     * em seguida, depois de qualquer outra carga feita em dict.
+     * Lanca runtime_error se o checkpoint foi gravado para outra entrada.
+     *
+     * @param dict := dicionario vazio que recebe o estado salvo.
+     * @param found := recebe true se havia algum estado salvo.
+     * @param source := identidade da entrada que sera lida.
+     */
+    template <typename Dict>
+    uint64_t resume(Dict& dict, bool& found, const snapshot::Source& source) {
+        uint64_t offset = 0;
+        found = false;
+        m_source = source;
+
+        if(std::FILE* test = std::fopen(m_snap.c_str(), "rb")) {
+            std::fclose(test);
+            snapshot::Reader<Value> reader(m_snap);
+            if(reader.source() != source) {
+                throw std::runtime_error("O checkpoint " + m_snap + " foi gravado para outra entrada");
+            }
+            for(size_t i = 0; i < reader.size(); i++) {
+                dict.insert(std::string(reader.key(i)), reader.value(i));
+            }
+            offset = reader.source_offset();
+            found = true;
+        }
+
+        uint64_t snap_offset = offset;
+        found = _replay(m_prev, dict, snap_offset, offset) || found;
+        found = _replay(m_log, dict, snap_offset, offset) || found;
+        return offset;
+    }
+
+    /**
+     * @brief Recomeca de um estado limpo: grava um snapshot com todo o conteudo
+     * de dict na posicao offset e abre um log vazio. Assim o primeiro snapshot
+     * ja inclui o que foi carregado em dict antes da leitura.
+     *
+     * @param dict := dicionario com o estado atual.
+     * @param offset := posicao da entrada representada por dict.
+     */
+    template <typename Dict>
+    void start(Dict& dict, uint64_t offset) {
+        snapshot::write(m_snap, dict.getAll(), offset, m_source);
+        std::remove(m_prev.c_str());
+        _openLog();
+    }
+
+    /**
+     * @brief Registra uma ocorrencia de word no lote atual.
+     */
+    void record(const std::string& word) {
+        m_batch[word]++;
+    }
+
+    /**
+     * @brief Acrescenta o lote atual ao log, marcado com a posicao da entrada
+     * logo apos as linhas que ele contem.
+     *
+     * @param end_offset := posicao da entrada apos o lote.
+     */
+    void commitBatch(uint64_t end_offset) {
+        std::string payload;
+        for(const auto& p : m_batch) {
+            uint32_t length = static_cast<uint32_t>(p.first.size());
+            payload.append(reinterpret_cast<const char*>(&length), sizeof(length));
+            payload.append(p.first);
+            payload.append(reinterpret_cast<const char*>(&p.second), sizeof(Value));
+        }
+        uint64_t payload_bytes = payload.size();
+        uint64_t checksum = _checksum(end_offset, payload_bytes, payload);
+        bool ok = std::fwrite(&end_offset, sizeof(end_offset), 1, m_file) == 1;
+        ok = ok && std::fwrite(&payload_bytes, sizeof(payload_bytes), 1, m_file) == 1;
+        ok = ok && std::fwrite(&checksum, sizeof(checksum), 1, m_file) == 1;
+        ok = ok && std::fwrite(payload.data(), 1, payload.size(), m_file) == payload.size();
+        ok = ok && std::fflush(m_file) == 0;
+        if(!ok) {
+            throw std::runtime_error("Erro ao escrever o log " + m_log);
+        }
+        m_batch.clear();
+    }
+
+    /**
+     * @brief Inicia a gravacao de um snapshot em segundo plano.
+     * O log atual passa a ser base.log.prev e um log novo eh aberto; quando o
+     * snapshot termina de ser gravado, base.log.prev deixa de ser necessario e eh apagado.
+     * Deve ser chamado logo apos commitBatch(offset).
+     *
+     * @param frozen := copia dos pares do dicionario na posicao offset.
+     * @param offset := posicao da entrada representada pela copia.
+     */
+    void takeSnapshot(std::vector<std::pair<std::string, Value>> frozen, uint64_t offset) {
+        _wait();
+        std::fclose(m_file);
+        m_file = nullptr;
+        if(std::rename(m_log.c_str(), m_prev.c_str()) != 0) {
+            throw std::runtime_error("Erro ao rotacionar o log " + m_log);
+        }
+        _openLog();
+
+        m_writer = std::thread([this, frozen = std::move(frozen), offset]() mutable {
+            try {
+                snapshot::write(m_snap, std::move(frozen), offset, m_source);
+                std::remove(m_prev.c_str());
+            } catch(...) {
+                m_failed = true;
+            }
+        });
+    }
+
+    /**
+     * @brief Espera o snapshot em andamento e apaga os arquivos do checkpoint,
+     * ja que a contagem terminou.
+     */
+    void finish() {
+        _wait();
+        std::fclose(m_file);
+        m_file = nullptr;
+        std::remove(m_log.c_str());
+        std::remove(m_prev.c_str());
+        std::remove(m_snap.c_str());
+    }
+
+private:
+    std::string m_snap;  // base.snap
+    std::string m_log;   // base.log
+    std::string m_prev;  // base.log.prev
+    std::FILE* m_file;   // log aberto para acrescimo
+    std::unordered_map<std::string, Value> m_batch; // incrementos ainda nao escritos
+    std::thread m_writer; // thread que grava o snapshot
+    bool m_failed;        // a ultima gravacao em segundo plano falhou
+    snapshot::Source m_source; // entrada a que os snapshots se referem
+
+    /**
+     * @brief Espera a thread do snapshot anterior; se ela falhou, base.log.prev
+     * ainda eh necessario, entao o checkpoint nao pode continuar.
+     */
+    void _wait() {
+        if(m_writer.joinable()) {
+            m_writer.join();
+        }
+        if(m_failed) {
+            throw std::runtime_error("Erro ao gravar o snapshot " + m_snap);
+        }
+    }
+
+    void _openLog() {
+        m_file = std::fopen(m_log.c_str(), "wb");
+        if(m_file == nullptr) {
+            throw std::runtime_error("Não foi possível criar o log " + m_log);
+        }
+    }
+
+    /**
+     * @brief FNV-1a de um lote, para reconhecer um lote escrito pela metade
+     * ou corrompido.
+     */
+    static uint64_t _checksum(uint64_t end_offset, uint64_t payload_bytes, const std::string& payload) {
+        uint64_t hash = 14695981039346656037ULL;
+        auto mix = [&hash](const char* bytes, size_t size) {
+            for(size_t i = 0; i < size; i++) {
+                hash = (hash ^ static_cast<unsigned char>(bytes[i])) * 1099511628211ULL;
+            }
+        };
+        mix(reinterpret_cast<const char*>(&end_offset), sizeof(end_offset));
+        mix(reinterpret_cast<const char*>(&payload_bytes), sizeof(payload_bytes));
+        mix(payload.data(), payload.size());
+        return hash;
+    }
+
+    /**
+     * @brief Separa o payload de um lote em pares (palavra, incremento),
+     * conferindo cada campo contra o tamanho do payload.
+     * Retorna false se o payload estiver malformado.
+     */
+    static bool _parse(const std::string& payload, std::vector<std::pair<std::string, Value>>& entries) {
+        size_t pos = 0;
+        while(pos < payload.size()) {
+            uint32_t length;
+            Value count;
+            if(payload.size() - pos < sizeof(length)) {
+                return false;
+            }
+            std::memcpy(&length, payload.data() + pos, sizeof(length));
+            pos += sizeof(length);
+            if(payload.size() - pos < uint64_t(length) + sizeof(Value)) {
+                return false;
+            }
+            std::string word = payload.substr(pos, length);
+            pos += length;
+            std::memcpy(&count, payload.data() + pos, sizeof(Value));
+            pos += sizeof(Value);
+            entries.emplace_back(std::move(word), count);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Aplica em dict os lotes completos de um log cujo end_offset seja
+     * maior que snap_offset, atualizando offset com a maior posicao aplicada.
+     * A leitura para no primeiro lote incompleto ou com checksum errado (o fim
+     * de uma escrita interrompida); um lote com checksum certo mas payload
+     * malformado lanca runtime_error.
+     * Retorna true se algum lote foi aplicado.
+     */
+    template <typename Dict>
+    bool _replay(const std::string& path, Dict& dict, uint64_t snap_offset, uint64_t& offset) {
+        std::FILE* file = std::fopen(path.c_str(), "rb");
+        if(file == nullptr) {
+            return false;
+        }
+        uint64_t remaining = 0;
+        if(std::fseek(file, 0, SEEK_END) == 0) {
+            long size = std::ftell(file);
+            remaining = size > 0 ? static_cast<uint64_t>(size) : 0;
+        }
+        std::rewind(file);
+
+        bool applied = false;
+        uint64_t end_offset = 0;
+        uint64_t payload_bytes = 0;
+        uint64_t checksum = 0;
+        std::string payload;
+        std::vector<std::pair<std::string, Value>> entries;
+        const uint64_t header = sizeof(end_offset) + sizeof(payload_bytes) + sizeof(checksum);
+        while(remaining >= header
+            && std::fread(&end_offset, sizeof(end_offset), 1, file) == 1
+            && std::fread(&payload_bytes, sizeof(payload_bytes), 1, file) == 1
+            && std::fread(&checksum, sizeof(checksum), 1, file) == 1) {
+            remaining -= header;
+            if(payload_bytes > remaining) {
+                break; // lote incompleto ou tamanho corrompido
+            }
+            payload.resize(payload_bytes);
+            if(payload_bytes > 0 && std::fread(&payload[0], 1, payload_bytes, file) != payload_bytes) {
+                break;
+            }
+            remaining -= payload_bytes;
+            if(_checksum(end_offset, payload_bytes, payload) != checksum) {
+                break; // a escrita foi interrompida no meio do lote
+            }
+            if(end_offset <= snap_offset) {
+                continue; // ja contido no snapshot
+            }
+            entries.clear();
+            if(!_parse(payload, entries)) {
+                std::fclose(file);
+                throw std::runtime_error("Log corrompido: " + path);
+            }
+            for(auto& entry : entries) {
+                dict.insert(entry.first, entry.second);
+            }
+            offset = end_offset;
+            applied = true;
+        }
+        std::fclose(file);
+        return applied;
+    }
+};
+
+#endif // END of CHECKPOINT_HPP
@@ -4,30 +4,48 @@
 #include <string>
 #include <utility>
 #include <vector>
+#include <type_traits>
 
+#include "structures/StringPool.hpp"
+#include "Snapshot.hpp"
+
+/**
+ * @brief Dicionario de frequencias sobre uma das estruturas (Class).
+ *
+ * Chaves std::string sao copiadas uma unica vez para um StringPool e a estrutura
+ * guarda apenas handles compactos (PooledString); os demais tipos de chave sao
+ * guardados diretamente.
+ */
 template <template<typename, typename...> class Class, typename Key, typename Value>
 class Dictionary {
+    // tipo de chave guardado na estrutura
+    using Stored = typename Interned<Key>::type;
+
 public:
     Dictionary() {}
 
     void insert(Key k) {
-        if(contains(k)) {
-            estrutura[k]++;
-        } else {
-            estrutura.insert(k,1);
-        }
+        slot(k)++;
+    }
+
+    /**
+     * @brief Soma count a contagem de k (usado ao carregar snapshots e logs).
+     */
+    void insert(Key k, Value count) {
+        slot(k) += count;
     }
 
     void clear() {
         estrutura.clear();
+        pool.clear();
     }
 
     Value& at(Key k) {
-        return estrutura.at(k);
+        return estrutura.at(Stored(k));
     }
 
     bool contains(Key k) {
-        return estrutura.contains(k);
+        return estrutura.contains(Stored(k));
     }
 
     std::string getParameters() {
@@ -35,11 +53,61 @@ public:
     }
 
     std::vector<std::pair<Key, Value>> getAll(){
-        return estrutura.getAll();
+        if constexpr (std::is_same<Stored, Key>::value) {
+            return estrutura.getAll();
+        } else {
+            std::vector<std::pair<Key, Value>> vec;
+            for(const auto& p : estrutura.getAll()) {
+                vec.push_back({static_cast<Key>(p.first), p.second});
+            }
+            return vec;
+        }
+    }
+
+    /**
+     * @brief Salva todos os pares em um snapshot binario (ver Snapshot.hpp).
+     *
+     * @param path := caminho do arquivo.
+     */
+    void save(const std::string& path) {
+        snapshot::write(path, getAll());
+    }
+
+    /**
+     * @brief Soma ao dicionario os pares de um snapshot salvo com save().
+     * O arquivo eh mapeado em memoria, entao nao ha tokenizacao nem parsing de texto.
+     *
+     * @param path := caminho do arquivo.
+     */
+    void load(const std::string& path) {
+        snapshot::Reader<Value> reader(path);
+        for(size_t i = 0; i < reader.size(); i++) {
+            insert(Key(reader.key(i)), reader.value(i));
+        }
     }
 
 private:
-    Class<Key, Value> estrutura;
+    Class<Stored, Value> estrutura;
+    StringPool pool;
+
+    /**
+     * @brief Retorna uma referencia ao valor de k, criando o par com Value() se preciso.
+     * Para chaves interned a chave so fica no pool se a estrutura criou um novo par com ela.
+     *
+     * @param k := chave
+     */
+    Value& slot(const Key& k) {
+        if constexpr (std::is_same<Stored, Key>::value) {
+            return estrutura[k];
+        } else {
+            size_t before = estrutura.size();
+            Value& v = estrutura[pool.stage(k)];
+            if(estrutura.size() != before) {
+                pool.commit();
+            }
+            return v;
+        }
+    }
 
 };
 
@@ -0,0 +1,311 @@
+/**
+ * @file Snapshot.hpp
+ * @author Paulo Henrique (phenriquedss@alu.ufc.br)
+ * @brief Formato binario para salvar e carregar dicionarios
+ * Estrutura de dados avancada - 2025.1
+ * @version 0.1
+ * @date 2025-07-10
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * Layout do arquivo (inteiros na ordem de bytes da maquina):
+ *
+ *   Header                         56 bytes
+ *   uint64_t offsets[count + 1]    inicio de cada chave no blob (offsets[count] = blob_size)
+ *   Value    values[count]         contagens, na mesma ordem das chaves
+ *   char     blob[blob_size]       bytes das chaves, concatenados sem separador
+ *
+ * As chaves ficam ordenadas byte a byte, entao um leitor pode mapear o arquivo
+ * com mmap e fazer busca binaria direto nele, sem nenhuma etapa de parsing.
+ *
+ * O cabecalho tambem guarda a posicao no arquivo de entrada ate onde o texto ja
+ * foi contado e a identidade desse arquivo (usados pelo checkpoint).
+ */
+namespace snapshot {
+
+    // identificador do formato e versao atual
+    static const char MAGIC[8] = {'E', 'D', 'A', 'D', 'I', 'C', 'T', '\0'};
+    static const uint32_t VERSION = 1;
+
+    /**
+     * @brief Identidade do arquivo de entrada: tamanho e data de modificacao.
+     * Zerada quando o snapshot nao esta associado a uma entrada.
+     */
+    struct Source {
+        uint64_t size;
+        int64_t mtime;  // em nanossegundos
+
+        bool operator==(const Source& other) const {
+            return size == other.size && mtime == other.mtime;
+        }
+
+        bool operator!=(const Source& other) const {
+            return !(*this == other);
+        }
+    };
+
+    /**
+     * @brief Cabecalho do arquivo.
+     */
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t value_size;  // sizeof(Value) de quem escreveu
+        uint64_t count;       // quantidade de pares
+        uint64_t blob_size;   // tamanho do blob de chaves em bytes
+        uint64_t source_offset; // bytes da entrada ja contados
+        Source source;        // entrada a que source_offset se refere
+    };
+
+    /**
+     * @brief Retorna a identidade do arquivo em path ou lanca runtime_error se
+     * ele nao puder ser consultado.
+     */
+    inline Source identify(const std::string& path) {
+        struct stat st;
+        if(::stat(path.c_str(), &st) != 0) {
+            throw std::runtime_error("Não foi possível consultar o arquivo " + path);
+        }
+        Source source;
+        source.size = static_cast<uint64_t>(st.st_size);
+        source.mtime = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+        return source;
+    }
+
+    /**
+     * @brief Escreve os pares em path. O arquivo eh escrito em path.tmp e so entao
+     * renomeado, assim um leitor nunca ve um snapshot pela metade.
+     *
+     * @param path := caminho do arquivo.
+     * @param pairs := pares (chave, valor) a serem salvos; sao ordenados pela chave.
+     * @param source_offset := posicao na entrada que esses pares representam.
+     * @param source := identidade da entrada.
+     */
+    template <typename Value>
+    void write(const std::string& path, std::vector<std::pair<std::string, Value>> pairs,
+               uint64_t source_offset = 0, Source source = Source{0, 0}) {
+        static_assert(std::is_trivially_copyable<Value>::value, "Value deve ser trivialmente copiavel");
+
+        std::sort(pairs.begin(), pairs.end(),
+            [](const std::pair<std::string, Value>& a, const std::pair<std::string, Value>& b) {
+                return a.first < b.first;
+            });
+
+        Header header;
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.value_size = sizeof(Value);
+        header.count = pairs.size();
+        header.blob_size = 0;
+        header.source_offset = source_offset;
+        header.source = source;
+
+        std::vector<uint64_t> offsets;
+        std::vector<Value> values;
+        offsets.reserve(pairs.size() + 1);
+        values.reserve(pairs.size());
+        for(const auto& p : pairs) {
+            offsets.push_back(header.blob_size);
+            values.push_back(p.second);
+            header.blob_size += p.first.size();
+        }
+        offsets.push_back(header.blob_size);
+
+        std::string tmp = path + ".tmp";
+        FILE* file = std::fopen(tmp.c_str(), "wb");
+        if(file == nullptr) {
+            throw std::runtime_error("Não foi possível criar o snapshot " + tmp);
+        }
+        bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+        ok = ok && std::fwrite(offsets.data(), sizeof(uint64_t), offsets.size(), file) == offsets.size();
+        ok = ok && (values.empty() || std::fwrite(values.data(), sizeof(Value), values.size(), file) == values.size());
+        for(const auto& p : pairs) {
+            ok = ok && std::fwrite(p.first.data(), 1, p.first.size(), file) == p.first.size();
+        }
+        ok = (std::fclose(file) == 0) && ok;
+        if(!ok || std::rename(tmp.c_str(), path.c_str()) != 0) {
+            std::remove(tmp.c_str());
+            throw std::runtime_error("Erro ao escrever o snapshot " + path);
+        }
+    }
+
+    /**
+     * @brief Snapshot mapeado em memoria somente leitura.
+     * Abrir o arquivo custa apenas o mmap e a validacao do cabecalho;
+     * as chaves e contagens sao lidas direto das paginas mapeadas. Os offsets
+     * de cada chave sao conferidos em key(i), no acesso, em vez de todos na
+     * abertura.
+     *
+     * @tparam Value tipo das contagens
+     */
+    template <typename Value>
+    class Reader {
+    public:
+        /**
+         * @brief Mapeia o arquivo em path e valida o cabecalho.
+         * Lanca runtime_error se o arquivo nao existir ou nao for um snapshot valido.
+         *
+         * @param path := caminho do arquivo.
+         */
+        explicit Reader(const std::string& path) {
+            m_base = nullptr;
+            m_length = 0;
+
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if(fd < 0) {
+                throw std::runtime_error("Não foi possível abrir o snapshot " + path);
+            }
+            struct stat st;
+            if(::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(Header)) {
+                ::close(fd);
+                throw std::runtime_error("Snapshot invalido: " + path);
+            }
+            m_length = st.st_size;
+            void* base = ::mmap(nullptr, m_length, PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+            if(base == MAP_FAILED) {
+                throw std::runtime_error("Erro ao mapear o snapshot " + path);
+            }
+            m_base = static_cast<const char*>(base);
+
+            const Header* header = reinterpret_cast<const Header*>(m_base);
+            if(std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != VERSION
+                || header->value_size != sizeof(Value) || !_fits(header)) {
+                ::munmap(const_cast<char*>(m_base), m_length);
+                throw std::runtime_error("Snapshot invalido: " + path);
+            }
+            m_count = header->count;
+            m_source_offset = header->source_offset;
+            m_source = header->source;
+            m_offsets = reinterpret_cast<const uint64_t*>(m_base + sizeof(Header));
+            m_values = reinterpret_cast<const Value*>(m_offsets + m_count + 1);
+            m_blob = reinterpret_cast<const char*>(m_values + m_count);
+            m_blob_size = header->blob_size;
+        }
+
+        ~Reader() {
+            if(m_base != nullptr) {
+                ::munmap(const_cast<char*>(m_base), m_length);
+            }
+        }
+
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        /**
+         * @brief Retorna a quantidade de pares do snapshot.
+         */
+        size_t size() const {
+            return m_count;
+        }
+
+        /**
+         * @brief Retorna a i-esima chave (em ordem crescente).
+         * Lanca runtime_error se os offsets da chave sairem do blob.
+         */
+        std::string_view key(size_t i) const {
+            uint64_t begin = m_offsets[i];
+            uint64_t end = m_offsets[i + 1];
+            if(begin > end || end > m_blob_size) {
+                throw std::runtime_error("Snapshot corrompido: chave " + std::to_string(i) + " fora do blob");
+            }
+            return std::string_view(m_blob + begin, end - begin);
+        }
+
+        /**
+         * @brief Retorna o valor associado a i-esima chave.
+         */
+        Value value(size_t i) const {
+            Value v;
+            std::memcpy(&v, m_values + i, sizeof(Value));
+            return v;
+        }
+
+        /**
+         * @brief Busca binaria por k; retorna seu indice ou -1 caso nao esteja presente.
+         *
+         * @param k := chave procurada.
+         */
+        size_t find(std::string_view k) const {
+            size_t lo = 0;
+            size_t hi = m_count;
+            while(lo < hi) {
+                size_t mid = (lo + hi) / 2;
+                if(key(mid) < k) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
+                }
+            }
+            if(lo < m_count && key(lo) == k) {
+                return lo;
+            }
+            return static_cast<size_t>(-1);
+        }
+
+        bool contains(std::string_view k) const {
+            return find(k) != static_cast<size_t>(-1);
+        }
+
+        /**
+         * @brief Retorna a posicao da entrada gravada junto do snapshot.
+         */
+        uint64_t source_offset() const {
+            return m_source_offset;
+        }
+
+        /**
+         * @brief Retorna a identidade da entrada gravada junto do snapshot.
+         */
+        Source source() const {
+            return m_source;
+        }
+
+    private:
+        /**
+         * @brief Verifica, sem overflow, se os tres vetores descritos pelo
+         * cabecalho ocupam exatamente o resto do arquivo.
+         */
+        bool _fits(const Header* header) const {
+            uint64_t room = m_length - sizeof(Header);
+            uint64_t entry = sizeof(uint64_t) + sizeof(Value);
+            if(room < sizeof(uint64_t) || header->count > (room - sizeof(uint64_t)) / entry) {
+                return false;
+            }
+            return room - sizeof(uint64_t) - header->count * entry == header->blob_size;
+        }
+
+        const char* m_base;      // inicio do arquivo mapeado
+        size_t m_length;         // tamanho do arquivo
+        size_t m_count;          // quantidade de pares
+        uint64_t m_source_offset; // posicao da entrada gravada no cabecalho
+        Source m_source;         // entrada gravada no cabecalho
+        const uint64_t* m_offsets;
+        const Value* m_values;
+        const char* m_blob;
+        uint64_t m_blob_size;    // tamanho do blob, limite dos offsets
+    };
+}
+
+#endif // END of SNAPSHOT_HPP
@@ -19,11 +19,25 @@
 #include "structures/Chained_HashTable.hpp"
 #include "structures/OpenAdress_HashTable.hpp"
 #include "structures/RbTree.hpp"
+#include "structures/BpTree.hpp"
 #include "Dictionary.hpp"
+#include "Checkpoint.hpp"
 
 using namespace std; 
 using namespace icu;
 
+// opcoes passadas por linha de comando alem da estrutura e dos arquivos
+struct Opcoes{
+    string load; // snapshot carregado antes de ler a entrada
+    string save; // snapshot salvo ao final
+    string checkpoint; // prefixo dos arquivos de checkpoint
+};
+
+// linhas da entrada por lote do log de checkpoint
+const int LINHAS_POR_LOTE = 4096;
+// lotes entre dois snapshots do checkpoint
+const int LOTES_POR_SNAPSHOT = 256;
+
 
 UnicodeString string_treatment(UnicodeString str){
     UnicodeString treated_word;
@@ -110,18 +124,45 @@ bool compareStrings(const pair<string, int>& a, const pair<string, int>& b){
 }
 
 template <template<typename, typename...> class ClassType, typename KeyType, typename ValueType>
-void process(Dictionary<ClassType, KeyType, ValueType>& dict, const string& structure, const string& in, string& out){
+void process(Dictionary<ClassType, KeyType, ValueType>& dict, const string& structure, const string& in, string& out, const Opcoes& opcoes){
 
-    ifstream entrada(in);
+    ifstream entrada;
 
-    if (!entrada) {
-        throw runtime_error("Não foi possível abrir o arquivo para leitura.");
+    if (!in.empty()) {
+        entrada.open(in);
+        if (!entrada) {
+            throw runtime_error("Não foi possível abrir o arquivo para leitura.");
+        }
     }
 
     string conteudo;
 
+    // posicao da entrada ja contada, usada pelo checkpoint
+    uint64_t offset = 0;
+    long long linhas = 0;
+    unique_ptr<Checkpoint<ValueType>> checkpoint;
+
     auto start = std::chrono::high_resolution_clock::now();
-    while (getline(entrada, conteudo)) {
+    bool retomado = false;
+    if (!opcoes.checkpoint.empty()) {
+        checkpoint.reset(new Checkpoint<ValueType>(opcoes.checkpoint));
+        snapshot::Source fonte = in.empty() ? snapshot::Source{0, 0} : snapshot::identify(in);
+        offset = checkpoint->resume(dict, retomado, fonte);
+    }
+    if (!opcoes.load.empty() && !retomado) {
+        dict.load(opcoes.load);
+    }
+    if (checkpoint) {
+        // so depois do --load, para que o primeiro snapshot ja o contenha
+        checkpoint->start(dict, offset);
+    }
+    if (offset > 0) {
+        entrada.seekg(offset);
+        if (!entrada) {
+            throw runtime_error("Não foi possível retomar a leitura da entrada na posição " + to_string(offset) + ".");
+        }
+    }
+    while (entrada.is_open() && getline(entrada, conteudo)) {
         UnicodeString aux = UnicodeString::fromUTF8(conteudo);
         
         vector<UnicodeString> individual_words = split_words(aux.toLower());
@@ -130,15 +171,31 @@ void process(Dictionary<ClassType, KeyType, ValueType>& dict, const string& stru
             string word;
             str.toUTF8String(word);
             dict.insert(word);
+            if (checkpoint) {
+                checkpoint->record(word);
+            }
         }  
+
+        offset += conteudo.size() + 1;
+        linhas++;
+        if (checkpoint && linhas % LINHAS_POR_LOTE == 0) {
+            checkpoint->commitBatch(offset);
+            if (linhas % (LINHAS_POR_LOTE * LOTES_POR_SNAPSHOT) == 0) {
+                checkpoint->takeSnapshot(dict.getAll(), offset);
+            }
+        }
     }
     auto end = std::chrono::high_resolution_clock::now();
     auto duration = end-start;
 
     entrada.close();
+
+    if (!opcoes.save.empty()) {
+        dict.save(opcoes.save);
+    }
         
     if(out.empty()){
-        out = structure + "_" + in;
+        out = structure + "_" + (in.empty() ? opcoes.load : in);
     }
 
     ofstream saida(out);
@@ -162,36 +219,56 @@ void process(Dictionary<ClassType, KeyType, ValueType>& dict, const string& stru
         saida << pair.first << setw(25-length) << " | " << pair.second << "\n";
     }
     saida.close();
+
+    if (checkpoint) {
+        checkpoint->finish();
+    }
 }
 
 int main(int argc, char* argv[]){
     vector<string> argumentos;
+    Opcoes opcoes;
+
+    for(int i = 1; i < argc; i++){
+        string arg = argv[i];
+        if((arg == "--load" || arg == "--save") && i + 1 < argc){
+            (arg == "--load" ? opcoes.load : opcoes.save) = argv[++i];
+        }else if(arg == "--checkpoint" && i + 1 < argc){
+            opcoes.checkpoint = argv[++i];
+        }else{
+            argumentos.push_back(arg);
+        }
+    }
 
-    if(argc < 3 || argc > 4){
+    if(argumentos.size() < 2 || argumentos.size() > 3){
         std::cerr << "Erro: Numero incorreto de argumentos." << std::endl;
         return 1; 
     }
 
-    string structure = argv[1]; 
-    string in = argv[2];       
+    string structure = argumentos[0]; 
+    // "-" no lugar da entrada: usa somente o snapshot carregado com --load
+    string in = argumentos[1] == "-" ? "" : argumentos[1];
     string out;
-    if(argc == 4){ 
-        out = argv[3];
+    if(argumentos.size() == 3){ 
+        out = argumentos[2];
     }
 
     try{
         if(structure ==  "dictionary_avl"){
             Dictionary<AvlTree, string, int> dict;
-            process(dict, "avl", in, out);
+            process(dict, "avl", in, out, opcoes);
         }else if(structure ==  "dictionary_rb"){
             Dictionary<RbTree, string, int> dict;
-            process(dict, "rb", in, out);
+            process(dict, "rb", in, out, opcoes);
         }else if(structure ==  "dictionary_cht"){
             Dictionary<Chained_HashTable, string, int> dict;
-            process(dict, "cht", in, out);
+            process(dict, "cht", in, out, opcoes);
         }else if(structure ==  "dictionary_oah"){
             Dictionary<OpenAdress_HashTable, string, int> dict;
-            process(dict, "oah", in, out);
+            process(dict, "oah", in, out, opcoes);
+        }else if(structure ==  "dictionary_bpt"){
+            Dictionary<BpTree, string, int> dict;
+            process(dict, "bpt", in, out, opcoes);
         }else{
             throw runtime_error("Estrutura inexistente");
         }
@@ -12,10 +12,11 @@
 #ifndef AVLTREE_HPP
 #define AVLTREE_HPP
 #include <iostream>
-#include <stack>
 #include <utility>
 #include <algorithm>
 #include <string>
+#include <vector>
+#include <stdexcept>
 
 
 /**
@@ -38,6 +39,7 @@ public:
     AvlTree(){
         compare_count = 0;
         rotate_count = 0;
+        m_number_of_elements = 0;
         _root = nullptr;
     }
     
@@ -48,6 +50,9 @@ public:
     ~AvlTree(){
         _root = _clear(_root);
     }
+
+    AvlTree(const AvlTree&) = delete;
+    AvlTree& operator=(const AvlTree&) = delete;
     
     /**
      * @brief insert privado que caminha pela arvore fazendo comparações com a chave e 
@@ -57,7 +62,7 @@ public:
      * @param v := valor 
      */
     void insert(Key k, Value v){
-        _root = _insert(_root, k, v);
+        _insert(k, v);
     }
 
     /**
@@ -77,6 +82,7 @@ public:
     void clear(){
         compare_count = 0;
         rotate_count = 0;
+        m_number_of_elements = 0;
         _root = _clear(_root);
     }
 
@@ -87,7 +93,7 @@ public:
      * @param k := chave a ser removida
      */
     void erase(Key k){
-        _root = _remove(_root, k);
+        _remove(k);
     }
 
     /**
@@ -113,7 +119,7 @@ public:
      * 
      */
     size_t size() const{
-        return _size(_root);
+        return m_number_of_elements;
     }
 
     /**
@@ -122,6 +128,7 @@ public:
      */
     std::vector<std::pair<Key, Value>> getAll(){
         std::vector<std::pair<Key, Value>> vec; 
+        vec.reserve(m_number_of_elements);
         _getAll(_root, vec);
         return vec;
     }
@@ -150,26 +157,17 @@ public:
         return parameters;
     }
 
+    /**
+     * @brief Sobrecarga do operador de indexacao.
+     * Se a chave existir retorna uma referencia ao seu valor, caso contrario
+     * insere a chave com o valor default, rebalanceia e retorna uma referencia a ele.
+     * Faz uma unica descida na arvore.
+     * 
+     * @param k := chave
+     * @return Value& := valor associado a chave
+     */
     Value& operator[](const Key& k){
-        Node* node = _root;
-        std::stack<Node*> stack;
-        while(node != nullptr && node->pair.first != k){
-            stack.push(node);
-            if(node->pair.first < k){
-                node = node->right;
-            }else{
-                node = node->left;
-            }
-        }
-        if(node == nullptr){
-            node = new Node({k, Value()});
-            while(!stack.empty()){
-                Node* aux = stack.top();
-                stack.pop();
-                _fixupNode(aux, aux->pair.first);
-            }
-        }
-        return node->pair.second;
+        return _insert(k, Value())->pair.second;
     }
 
     const Value& operator[](const Key& k) const{
@@ -200,137 +198,182 @@ private:
             this->height = Altura;
         }
     };
+    // Altura maxima de uma AVL com ate 2^64 nos eh ~1.44 * 64 < 96,
+    // entao um vetor fixo desse tamanho guarda qualquer caminho raiz-folha.
+    static const int MAX_HEIGHT = 96;
+
     //Nó raiz e contadores do tipo size_t para suportar tamanhos imensos.
     Node *_root;
+    size_t m_number_of_elements;
     mutable size_t compare_count;
     mutable size_t rotate_count;
 
     /**
-     * @brief insert privado que caminha recursivamente pela arvore fazendo comparações com a chave e 
-     * caso ache, incrementa o valor da chave, se não, cria um novo par e adiciona na arvore
+     * @brief insert privado que caminha iterativamente pela arvore fazendo comparações com a chave e 
+     * caso ache, nao altera o valor da chave, se não, cria um novo par e adiciona na arvore.
+     * Os enderecos dos ponteiros visitados ficam em um vetor fixo, e o rebalanceamento
+     * sobe por esse caminho ate que a altura de uma subarvore deixe de mudar.
+     * Retorna o nó que guarda a chave (as rotações nao movem os pares entre nós).
      * 
-     * @param node := nó a partir do qual será iniciada a procura.
      * @param k := chave
      * @param v := valor 
      */
-    Node* _insert(Node *node, Key k, Value v){
-        if (node == nullptr){
-            return new Node({k, v}, nullptr, nullptr);
-        }
+    Node* _insert(const Key& k, const Value& v){
+        Node** path[MAX_HEIGHT];
+        int depth = 0;
+
+        Node** link = &_root;
+        while(*link != nullptr){
+            Node* node = *link;
+            compare_count++;
+            if (node->pair.first == k){
+                return node;
+            }
 
-        compare_count++;
-        if (node->pair.first == k){
-            return node;
+            path[depth++] = link;
+            compare_count++;
+            if (k < node->pair.first){
+                link = &node->left;
+            }else{
+                link = &node->right;
+            }
         }
+        Node* created = new Node({k, v}, nullptr, nullptr);
+        *link = created;
+        m_number_of_elements++;
 
-        compare_count++;
-        if (k < node->pair.first){
-            node->left = _insert(node->left, k, v);
-        }else{
-            node->right = _insert(node->right, k, v);
+        _fixupPath(path, depth, k);
+        return created;
+    }
+
+    /**
+     * @brief Rebalanceia, de baixo para cima, os nós do caminho de uma inserção.
+     * Se a altura de uma subarvore nao mudar (ou se houver rotacao, que restaura a
+     * altura anterior) os ancestrais nao sao afetados e o laço termina.
+     * 
+     * @param path := enderecos dos ponteiros visitados a partir da raiz.
+     * @param depth := quantidade de enderecos no caminho.
+     * @param k := chave inserida.
+     */
+    void _fixupPath(Node*** path, int depth, const Key& k){
+        while(depth > 0){
+            Node** link = path[--depth];
+            Node* node = *link;
+            int old_height = node->height;
+            *link = _fixupNode(node, k);
+            if((*link)->height == old_height){
+                break;
+            }
         }
-        node = _fixupNode(node, k);
-        return node;
     }
 
     /**
-     * @brief Procura recursivamente por uma chave e retorna o valor associado.
+     * @brief Procura iterativamente por uma chave e retorna o valor associado.
      * 
      * @param node := nó a partir do qual será iniciada a procura.
      * @param k := chave.
      * @return v := Valor associado a chave.
      */
-    Value& _at(Node* node, Key k) {
-        if (node == nullptr)
-            throw std::runtime_error("Key not found");
-
-        if (node->pair.first == k){
-            compare_count++;
-            return node->pair.second;
-        }else if (node->pair.first > k){
-            compare_count += 2;
-            return _at(node->left, k);
-        }else{
-            compare_count += 2;
-            return _at(node->right, k);
+    Value& _at(Node* node, const Key& k) const{
+        while (node != nullptr){
+            if (node->pair.first == k){
+                compare_count++;
+                return node->pair.second;
+            }else if (node->pair.first > k){
+                compare_count += 2;
+                node = node->left;
+            }else{
+                compare_count += 2;
+                node = node->right;
+            }
         }
+        throw std::runtime_error("Key not found");
     }
 
     /**
-     * @brief Limpa todos os elementos da árvore recursivamente.
+     * @brief Limpa todos os elementos da árvore sem recursao nem pilha:
+     * enquanto o nó tiver filho esquerdo, gira a direita (sem contar como rotacao
+     * de balanceamento), caso contrario o deleta e segue pela direita.
      * 
      * @param node := nó que será removido junto de seus filhos.
      */
     Node* _clear(Node *node){
-        if (node != nullptr){
-            node->left = _clear(node->left);
-            node->right = _clear(node->right);
-            delete node;
+        while (node != nullptr){
+            if (node->left != nullptr){
+                Node *aux = node->left;
+                node->left = aux->right;
+                aux->right = node;
+                node = aux;
+            }else{
+                Node *next = node->right;
+                delete node;
+                node = next;
+            }
         }
         return nullptr;
     }
 
     /**
-     * @brief Recebe como entrada um nó e uma chave k.
-     *  Se chegar em nullptr, retorna nullptr, caso contrário, 
-     *  verifica se k é menor ou maior e caminha nessa direção na árvore recursivamente,
-     *  caso não, verifica se o nó a direita é nullptr, se for guarda o nó a esquerda, deleta 
-     *  o nó atual retorna o nó guardado, se não o nó a direita recebe remove_sucessor mandando o node
-     *  e o nó a direita, então o node recebe fixUp deletion node e é retornado. 
+     * @brief Recebe como entrada uma chave k e a remove da árvore, caso exista.
+     *  Caminha iterativamente na direcao de k guardando os enderecos dos ponteiros visitados.
+     *  Se o nó encontrado nao tiver filho a direita, ele eh substituido pelo filho esquerdo,
+     *  caso contrario recebe o par do seu sucessor, que eh removido no lugar dele.
+     *  Ao final o caminho eh rebalanceado de baixo para cima com fixup_deletion, parando
+     *  assim que a altura de uma subarvore nao mudar.
      * 
-     * @param node := nó que a partir do qual será procurado a chave.
      * @param k := chave a ser removida.
      */
-    Node* _remove(Node *node, Key key){
-        if (node == nullptr)
-            return nullptr;
-
-        if (key < node->pair.first){
-            compare_count++;
-            node->left = _remove(node->left, key);
-        }else if (key > node->pair.first){
-            compare_count += 2;
-            node->right = _remove(node->right, key);
-        }else if (node->right == nullptr){
-            compare_count += 2;
-            Node *child = node->left;
-            delete node;
-            return child;
-        }else{
-            compare_count += 2;
-            node->right = remove_successor(node, node->right);
-            node = fixup_deletion(node);
-            return node;
+    void _remove(const Key& key){
+        Node** path[MAX_HEIGHT];
+        int depth = 0;
+
+        Node** link = &_root;
+        while (*link != nullptr){
+            Node *node = *link;
+            if (key < node->pair.first){
+                compare_count++;
+                path[depth++] = link;
+                link = &node->left;
+            }else if (key > node->pair.first){
+                compare_count += 2;
+                path[depth++] = link;
+                link = &node->right;
+            }else{
+                compare_count += 2;
+                break;
+            }
         }
 
-        node = fixup_deletion(node);
-        return node;
-    }
+        if (*link == nullptr)
+            return;
 
-    /**
-     * @brief Recebe um nó root e um nó node.
-     *  Se o nó a esquerda do node for diferente de nullptr, chama recursivamente a função,
-     *  atribui ao node->left e chama fixUp deletion e retorna o node.
-     *  Se não atribui o par do node ao par da raiz, guarda o node->right em um aux, 
-     *  então deleta o node e retorna o aux. 
-     * 
-     * @param _root := nó o qual vai ser removido.
-     * @param node := nó de substituição.
-     */
-    Node* remove_successor( Node * root , Node * node ) {
-        if( node -> left != nullptr ){
-            node -> left = remove_successor( root , node -> left );
-            node = fixup_deletion(node);
-            return node;
-        }else{
-            root -> pair = node -> pair;
-            Node * aux = node -> right;
+        Node *node = *link;
+        if (node->right == nullptr){
+            *link = node->left;
             delete node;
-            return aux;
+        }else{
+            // remove o sucessor (menor nó da subarvore direita) no lugar do nó
+            path[depth++] = link;
+            Node** succ = &node->right;
+            while ((*succ)->left != nullptr){
+                path[depth++] = succ;
+                succ = &(*succ)->left;
+            }
+            Node *aux = *succ;
+            node->pair = std::move(aux->pair);
+            *succ = aux->right;
+            delete aux;
+        }
+        m_number_of_elements--;
+
+        while (depth > 0){
+            link = path[--depth];
+            int old_height = (*link)->height;
+            *link = fixup_deletion(*link);
+            if ((*link)->height == old_height){
+                break;
+            }
         }
-
-        node = fixup_deletion(node);
-        return node ;
     }
 
     /**
@@ -361,27 +404,27 @@ private:
     }
 
     /**
-     * @brief Recebe um nó e uma chave k, se a recursão cheagar em null, retorna false
-     *  se a chave do nó atual da recursão for igual a chave procurada, retorna true,
-     *  caso contrário caminha pela árvore recursivamente na direção indicada pela comparação com a chave do nó atual. 
+     * @brief Recebe um nó e uma chave k, se a busca cheagar em null, retorna false
+     *  se a chave do nó atual for igual a chave procurada, retorna true,
+     *  caso contrário caminha pela árvore na direção indicada pela comparação com a chave do nó atual. 
      * 
      * @param node := nó "base" da busca.
      * @param k := chave buscada.
      */
-    bool _contains(Node *node, Key k) const{
-        if (node == nullptr)
-            return false;
-
-        if (node->pair.first == k){
-            compare_count++;
-            return true;
-        }else if (node->pair.first > k){
-            compare_count += 2;
-            return _contains(node->left, k);
-        }else{
-            compare_count += 2;
-            return _contains(node->right, k);
+    bool _contains(Node *node, const Key& k) const{
+        while (node != nullptr){
+            if (node->pair.first == k){
+                compare_count++;
+                return true;
+            }else if (node->pair.first > k){
+                compare_count += 2;
+                node = node->left;
+            }else{
+                compare_count += 2;
+                node = node->right;
+            }
         }
+        return false;
     }
 
     /**
@@ -399,20 +442,6 @@ private:
         }
     }
 
-    /**
-     * @brief Recebe um nó e retorna a quantidade de nós a partir dele.
-     *  verifica se o nó é nullptr, se for retorna 0, caso não,
-     *  retorna 1 + a recursão da função para os nós filhos. 
-     * 
-     * @param node := nó a partir do qual se deseja saber a quantidade de nós.
-     **/
-    size_t _size(Node *node) const{
-        if (node == nullptr)
-            return 0;
-
-        return _size(node->left) + _size(node->right) + 1;
-    }
-
     /**
      * @brief Recebe um nó e retorna o nó resultado da rotação a direita.
      *  guarda o filho esquerdo do nó em um aux, guarda o filho direito no esquerdo e o nó no seu filho direito,
@@ -505,17 +534,24 @@ private:
     }
 
     /**
-     * @brief Recebe um nó e a partir dele imprime os campos chave e valor do nó.
+     * @brief Recebe um nó e a partir dele copia os pares em ordem para o vetor.
+     *  Usa uma pilha de tamanho fixo, ja que a altura da AVL eh limitada.
      * 
-     * @param node := nó a partir do qual se deseja mostrar na árvore.
+     * @param node := nó a partir do qual se deseja percorrer a árvore.
      **/
     void _getAll(Node *node, std::vector<std::pair<Key, Value>>& vec){
-        if (node == nullptr)
-            return;
+        Node* stack[MAX_HEIGHT];
+        int top = 0;
 
-        _getAll(node->left, vec);
-        vec.push_back(node->pair);
-        _getAll(node->right, vec);
+        while (node != nullptr || top > 0){
+            while (node != nullptr){
+                stack[top++] = node;
+                node = node->left;
+            }
+            node = stack[--top];
+            vec.push_back(node->pair);
+            node = node->right;
+        }
     }
 
 };
@@ -0,0 +1,466 @@
+/**
+ * @file BpTree.hpp
+ * @author Paulo Henrique (phenriquedss@alu.ufc.br)
+ * @brief Arvore B+ com nos largos
+ * Estrutura de dados avancada - 2025.1
+ * @version 0.1
+ * @date 2025-07-02
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef BPTREE_HPP
+#define BPTREE_HPP
+#include <utility>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <algorithm>
+
+/**
+ * @brief Classe que implementa uma arvore B+ (B+ Tree).
+ *
+ * Diferente da AVL e da rubro-negra, cada no guarda varias chaves em um
+ * vetor contiguo, dimensionado para ocupar alguns blocos de cache (NODE_BYTES).
+ * Assim uma busca visita poucos nos (altura ~ log_{ORDER} n) e os pares ficam
+ * todos nas folhas, que sao encadeadas para permitir varreduras em ordem.
+ *
+ * Os tipos Key e Value, caso sejam classes, devem ter um construtor default.
+ * Além disso, o tipo Key deve sobrecarregar o operador de igualdade (==) e
+ * de comparação (<).
+ *
+ * @tparam Key key type
+ * @tparam Value value type
+ */
+template <typename Key, typename Value>
+class BpTree{
+public:
+    /**
+    * @brief Construtor padrão da classe, cria uma arvore B+ vazia.
+    */
+    BpTree(){
+        compare_count = 0;
+        split_count = 0;
+        m_number_of_elements = 0;
+        _root = nullptr;
+        _first = nullptr;
+    }
+
+    /**
+    * @brief Destrutor padrao da classe, libera todos os nos.
+    */
+    ~BpTree(){
+        _clear(_root);
+    }
+
+    BpTree(const BpTree&) = delete;
+    BpTree& operator=(const BpTree&) = delete;
+
+    /**
+    * @brief Deleta cada um dos elementos da estrutura.
+    */
+    void clear(){
+        compare_count = 0;
+        split_count = 0;
+        m_number_of_elements = 0;
+        _clear(_root);
+        _root = nullptr;
+        _first = nullptr;
+    }
+
+    /**
+    * @brief Insere um par de chave e valor na estrutura,
+    * caso a chave ja exista a estrutura nao eh alterada.
+    *
+    * @param k := Chave a ser inserida.
+    * @param v := Valor associado a chave.
+    */
+    void insert(Key k, Value v){
+        _upsert(k, v);
+    }
+
+    /**
+     * @brief Procura por uma chave e retorna o valor associado.
+     * Lanca uma exececao caso a chave nao esteja presente.
+     *
+     * @param k := chave
+     * @return v := Valor associado a chave
+     */
+    Value& at(Key k){
+        Leaf* leaf = _findLeaf(k);
+        int i = _leafIndex(leaf, k);
+        if(i < 0){
+            throw std::runtime_error("Key not found");
+        }
+        return leaf->values[i];
+    }
+
+    /**
+    * @brief Procura na estrutura uma chave, caso ache retorna true,
+    * caso nao, false.
+    *
+    * @param k := Chave a ser procurada.
+    */
+    bool contains(Key k){
+        return _leafIndex(_findLeaf(k), k) >= 0;
+    }
+
+    /**
+    * @brief Retorn true caso a estrutura esteja vazia, e false caso nao.
+    */
+    bool empty() const{
+        return m_number_of_elements == 0;
+    }
+
+    /**
+     * @brief retorna o a quantidade de elementos da arvore.
+     **/
+    size_t size() const{
+        return m_number_of_elements;
+    }
+
+    /**
+     * @brief Retorna todos os pares em ordem crescente de chave,
+     * percorrendo apenas a lista encadeada de folhas.
+     **/
+    std::vector<std::pair<Key, Value>> getAll(){
+        std::vector<std::pair<Key, Value>> vec;
+        vec.reserve(m_number_of_elements);
+        for(Leaf* leaf = _first; leaf != nullptr; leaf = leaf->next){
+            for(int i = 0; i < leaf->count; i++){
+                vec.push_back({leaf->keys[i], leaf->values[i]});
+            }
+        }
+        return vec;
+    }
+
+    /**
+     * @brief Retorna a quantidade de comparacoes de chave feitas na estrutura.
+     *
+     * @return size_t := quantidade de comparacoes.
+     **/
+    size_t getComparisons(){
+        return compare_count;
+    }
+
+    /**
+     * @brief Retorna a quantidade de divisoes de nos feitas na estrutura.
+     *
+     * @return size_t := quantidade de divisoes.
+     **/
+    size_t getSplits(){
+        return split_count;
+    }
+
+    std::string getParameters(){
+        std::string parameters = "Comparisons: " + std::to_string(getComparisons()) + "\n Splits: " + std::to_string(getSplits());
+        return parameters;
+    }
+
+    /**
+     * @brief Sobrecarga do operador de indexacao.
+     * Se a chave existir retorna uma referencia ao seu valor, caso contrario
+     * insere a chave com o valor default e retorna uma referencia a ele.
+     * Faz uma unica descida na arvore.
+     *
+     * @param k := chave
+     * @return Value& := valor associado a chave
+     */
+    Value& operator[](const Key& k){
+        return _upsert(k, Value());
+    }
+
+    const Value& operator[](const Key& k) const{
+        const Leaf* leaf = _findLeaf(k);
+        int i = _leafIndex(leaf, k);
+        if(i < 0){
+            throw std::runtime_error("Key not found");
+        }
+        return leaf->values[i];
+    }
+
+private:
+    // tamanho aproximado de cada no em bytes (16 linhas de cache de 64 bytes)
+    static const size_t NODE_BYTES = 1024;
+
+    // quantidade maxima de chaves por no
+    static const int ORDER = (NODE_BYTES / sizeof(Key)) < 8 ? 8 : int(NODE_BYTES / sizeof(Key));
+
+    // profundidade maxima possivel: cada no tem ao menos ORDER/2 >= 4 filhos
+    static const int MAX_DEPTH = 64;
+
+    /**
+    * @brief Parte comum dos nos: as chaves ficam contiguas para a busca binaria.
+    */
+    struct Node{
+        bool leaf;
+        int count;
+        Key keys[ORDER];
+
+        Node(bool folha){
+            this->leaf = folha;
+            this->count = 0;
+        }
+    };
+
+    /**
+    * @brief No interno: count chaves separam count+1 filhos.
+    * Todas as chaves de children[i+1] sao >= keys[i].
+    */
+    struct Inner : Node{
+        Node* children[ORDER + 1];
+
+        Inner() : Node(false){}
+    };
+
+    /**
+    * @brief No folha: guarda os pares e aponta para a proxima folha.
+    */
+    struct Leaf : Node{
+        Value values[ORDER];
+        Leaf* next;
+
+        Leaf() : Node(true){
+            this->next = nullptr;
+        }
+    };
+
+    Node *_root;  //no raiz da arvore
+    Leaf *_first; //folha mais a esquerda, inicio da varredura em ordem
+    size_t m_number_of_elements; //quantidade de pares
+    mutable size_t compare_count; //contador de comparacoes
+    mutable size_t split_count; //contador de divisoes de nos
+
+    /**
+    * @brief Busca binaria dentro de um no: retorna quantas chaves do no
+    * sao menores ou iguais a k (o indice do filho a ser seguido).
+    *
+    * @param node := no onde a busca eh feita.
+    * @param k := chave procurada.
+    */
+    int _upperBound(const Node* node, const Key& k) const{
+        int lo = 0;
+        int hi = node->count;
+        while(lo < hi){
+            int mid = (lo + hi) / 2;
+            compare_count++;
+            if(k < node->keys[mid]){
+                hi = mid;
+            }else{
+                lo = mid + 1;
+            }
+        }
+        return lo;
+    }
+
+    /**
+    * @brief Desce da raiz ate a folha onde a chave k estaria.
+    *
+    * @param k := chave procurada.
+    */
+    Leaf* _findLeaf(const Key& k) const{
+        Node* node = _root;
+        if(node == nullptr){
+            return nullptr;
+        }
+        while(!node->leaf){
+            Inner* inner = static_cast<Inner*>(node);
+            node = inner->children[_upperBound(inner, k)];
+        }
+        return static_cast<Leaf*>(node);
+    }
+
+    /**
+    * @brief Retorna o indice da chave k na folha, ou -1 caso nao esteja.
+    *
+    * @param leaf := folha onde a chave estaria.
+    * @param k := chave procurada.
+    */
+    int _leafIndex(const Leaf* leaf, const Key& k) const{
+        if(leaf == nullptr){
+            return -1;
+        }
+        int i = _upperBound(leaf, k);
+        if(i > 0){
+            compare_count++;
+            if(leaf->keys[i-1] == k){
+                return i - 1;
+            }
+        }
+        return -1;
+    }
+
+    /**
+    * @brief Procura a chave k e, caso nao exista, insere o par (k, v).
+    * A descida guarda o caminho em um vetor fixo para que as divisoes
+    * sejam propagadas de baixo para cima sem recursao.
+    * Retorna uma referencia ao valor associado a chave.
+    *
+    * @param k := Chave a ser inserida.
+    * @param v := Valor associado a chave.
+    */
+    Value& _upsert(const Key& k, const Value& v){
+        if(_root == nullptr){
+            Leaf* leaf = new Leaf();
+            leaf->keys[0] = k;
+            leaf->values[0] = v;
+            leaf->count = 1;
+            _root = _first = leaf;
+            m_number_of_elements++;
+            return leaf->values[0];
+        }
+
+        Inner* path[MAX_DEPTH];
+        int slot[MAX_DEPTH];
+        int depth = 0;
+
+        Node* node = _root;
+        while(!node->leaf){
+            Inner* inner = static_cast<Inner*>(node);
+            int i = _upperBound(inner, k);
+            path[depth] = inner;
+            slot[depth] = i;
+            depth++;
+            node = inner->children[i];
+        }
+
+        Leaf* leaf = static_cast<Leaf*>(node);
+        int pos = _upperBound(leaf, k);
+        if(pos > 0){
+            compare_count++;
+            if(leaf->keys[pos-1] == k){
+                return leaf->values[pos-1];
+            }
+        }
+
+        m_number_of_elements++;
+        if(leaf->count < ORDER){
+            _leafInsertAt(leaf, pos, k, v);
+            return leaf->values[pos];
+        }
+
+        // folha cheia: divide ao meio e insere na metade correta
+        split_count++;
+        Leaf* right = new Leaf();
+        int half = ORDER / 2;
+        for(int i = half; i < ORDER; i++){
+            right->keys[i - half] = std::move(leaf->keys[i]);
+            right->values[i - half] = std::move(leaf->values[i]);
+        }
+        right->count = ORDER - half;
+        leaf->count = half;
+        right->next = leaf->next;
+        leaf->next = right;
+
+        Leaf* target = leaf;
+        if(pos > half){
+            target = right;
+            pos -= half;
+        }
+        _leafInsertAt(target, pos, k, v);
+        Value& result = target->values[pos];
+
+        Key separator = right->keys[0];
+        Node* child = right;
+        while(depth > 0){
+            depth--;
+            Inner* parent = path[depth];
+            int i = slot[depth];
+            if(parent->count < ORDER){
+                _innerInsertAt(parent, i, separator, child);
+                return result;
+            }
+            child = _splitInner(parent, i, separator, child, separator);
+        }
+
+        // a raiz foi dividida: cria uma nova raiz
+        Inner* root = new Inner();
+        root->keys[0] = separator;
+        root->children[0] = _root;
+        root->children[1] = child;
+        root->count = 1;
+        _root = root;
+        return result;
+    }
+
+    /**
+    * @brief Insere o par (k, v) na posicao pos de uma folha com espaco livre.
+    */
+    void _leafInsertAt(Leaf* leaf, int pos, const Key& k, const Value& v){
+        for(int i = leaf->count; i > pos; i--){
+            leaf->keys[i] = std::move(leaf->keys[i-1]);
+            leaf->values[i] = std::move(leaf->values[i-1]);
+        }
+        leaf->keys[pos] = k;
+        leaf->values[pos] = v;
+        leaf->count++;
+    }
+
+    /**
+    * @brief Insere a chave separadora k na posicao pos de um no interno
+    * com espaco livre, com child a sua direita.
+    */
+    void _innerInsertAt(Inner* node, int pos, const Key& k, Node* child){
+        for(int i = node->count; i > pos; i--){
+            node->keys[i] = std::move(node->keys[i-1]);
+            node->children[i+1] = node->children[i];
+        }
+        node->keys[pos] = k;
+        node->children[pos+1] = child;
+        node->count++;
+    }
+
+    /**
+    * @brief Divide um no interno cheio ao inserir (k, child) na posicao pos.
+    * A chave do meio sobe para o pai atraves de up, e o novo no da direita eh retornado.
+    */
+    Inner* _splitInner(Inner* node, int pos, Key k, Node* child, Key& up){
+        split_count++;
+        // monta temporariamente as ORDER+1 chaves e ORDER+2 filhos
+        std::vector<Key> keys(node->keys, node->keys + ORDER);
+        std::vector<Node*> children(node->children, node->children + ORDER + 1);
+        keys.insert(keys.begin() + pos, std::move(k));
+        children.insert(children.begin() + pos + 1, child);
+
+        int half = (ORDER + 1) / 2;
+        Inner* right = new Inner();
+        node->count = half;
+        for(int i = 0; i < half; i++){
+            node->keys[i] = std::move(keys[i]);
+            node->children[i] = children[i];
+        }
+        node->children[half] = children[half];
+
+        up = std::move(keys[half]);
+
+        right->count = ORDER - half;
+        for(int i = 0; i < right->count; i++){
+            right->keys[i] = std::move(keys[half + 1 + i]);
+            right->children[i] = children[half + 1 + i];
+        }
+        right->children[right->count] = children[ORDER + 1];
+        return right;
+    }
+
+    /**
+    * @brief Recebe um nodo e o deleta junto de seus filhos da estrutura.
+    *
+    * @param node := No a partir do qual se comeca a limpar a estrutura.
+    */
+    void _clear(Node* node){
+        if(node == nullptr){
+            return;
+        }
+        if(node->leaf){
+            delete static_cast<Leaf*>(node);
+        }else{
+            Inner* inner = static_cast<Inner*>(node);
+            for(int i = 0; i <= inner->count; i++){
+                _clear(inner->children[i]);
+            }
+            delete inner;
+        }
+    }
+};
+
+#endif // END of BPTREE_HPP
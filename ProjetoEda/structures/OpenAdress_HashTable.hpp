@@ -18,6 +18,7 @@
 #include <vector>
 #include <utility>
 #include <functional>
+#include <stdexcept>
 
 /**
  * @brief Classe que implementa uma tabela hash com tratamento de
@@ -337,6 +338,18 @@ class OpenAdress_HashTable{
         }
     }
 
+    /**
+     * @brief Retorna uma referencia para o valor associado a chave k.
+     * Se k nao estiver na tabela, a funcao 
+     * lanca uma out_of_range exception.
+     * 
+     * @param k := chave
+     * @return V& := valor associado a chave
+     */
+    Value& at(const Key& k) {
+        return hashSearch(k);
+    }
+
     const Value& hashSearch(const Key& k) const {
         size_t j = aux_hashSearch(k);
 
@@ -449,6 +462,8 @@ class OpenAdress_HashTable{
      * referencia ao seu valor mapeado. Observe que isso sempre aumenta 
      * o tamanho da tabela em um, mesmo se nenhum valor mapeado for atribuido 
      * ao elemento (o elemento eh construido usando seu construtor padrao).
+     * Percorre a sequencia de sondagem uma unica vez, guardando o primeiro
+     * slot livre (EMPTY ou DELETED) para o caso da chave nao existir.
      * 
      * @param k := chave
      * @return Value& := valor associado a chave
@@ -457,14 +472,32 @@ class OpenAdress_HashTable{
         if(load_factor() >= m_max_load_factor) {
             rehash(2 * m_table_size);
         }
-        size_t i = aux_hashSearch(k);
-        if(i!= (size_t)-1){
-            return m_table[i]->pair.second;
-        }
+        size_t free_slot = static_cast<size_t>(-1);
+        size_t i = 0;
+        size_t j = 0;
+        do{
+            j = hash_code(k, i);
+            compare_count++;
+            if(m_table[j]->status == Status::ACTIVE){
+                if(m_table[j]->pair.first == k){
+                    return m_table[j]->pair.second;
+                }
+                if(free_slot == static_cast<size_t>(-1)){
+                    collide_count++;
+                }
+            }else if(free_slot == static_cast<size_t>(-1)){
+                free_slot = j;
+            }
+            i++;
+        }while(m_table[j]->status != Status::EMPTY && i < m_table_size);
 
-        insert(k, Value());
-        i = aux_hashSearch(k);
-        return m_table[i]->pair.second;
+        if(free_slot == static_cast<size_t>(-1)){
+            throw std::overflow_error("hash table is full");
+        }
+        m_table[free_slot]->pair = {k, Value()};
+        m_table[free_slot]->status = Status::ACTIVE;
+        m_number_of_elements++;
+        return m_table[free_slot]->pair.second;
     }
 
 
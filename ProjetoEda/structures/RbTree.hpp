@@ -13,6 +13,8 @@
 #define RBTREE_HPP
 #include <utility>
 #include <string>
+#include <vector>
+#include <stdexcept>
 
 /** 
  * @brief definição da coloração dos nós
@@ -39,6 +41,7 @@ public:
     RbTree(){
         compare_count = 0;
         rotate_count = 0;
+        m_number_of_elements = 0;
         T_nil = new Node(BLACK, {Key(), Value()}, nullptr, nullptr, nullptr);
         T_nil->left = T_nil->right = T_nil;
         _root = T_nil;
@@ -59,6 +62,7 @@ public:
     void clear(){
         compare_count = 0;
         rotate_count = 0;
+        m_number_of_elements = 0;
         _clear(_root);
         _root = T_nil;
     }
@@ -73,6 +77,17 @@ public:
         _insert(k, v);
     }
 
+    /**
+     * @brief Procura por uma chave e retorna o valor associado.
+     * Lanca uma exececao caso a chave nao esteja presente.
+     * 
+     * @param k := chave
+     * @return v := Valor associado a chave
+     */
+    Value& at(Key k){
+        return _at(_root, k);
+    }
+
     /**
     * @brief Remove um elemento baseado em uma chave.
     * 
@@ -103,8 +118,8 @@ public:
     /** 
      * @brief retorna o a quantidade de elementos da arvore.
      **/
-    int size(){
-        return _size(_root);
+    size_t size() const{
+        return m_number_of_elements;
     }
 
     std::vector<std::pair<Key, Value>> getAll() {
@@ -137,29 +152,17 @@ public:
         return parameters;
     }
 
+    /**
+     * @brief Sobrecarga do operador de indexacao.
+     * Se a chave existir retorna uma referencia ao seu valor, caso contrario
+     * insere a chave com o valor default, corrige a coloracao e retorna uma referencia a ele.
+     * Faz uma unica descida na arvore.
+     * 
+     * @param k := chave
+     * @return Value& := valor associado a chave
+     */
     Value& operator[](const Key& k){
-        Node* node = _root;
-        Node* pai = _root;
-        std::stack<Node*> stack;
-        while(node != T_nil && node->pair.first != k){
-            stack.push(node);
-            if(node->pair.first < k){
-                pai = node;
-                node = node->right;
-            }else{
-                pai = node;
-                node = node->left;
-            }
-        }
-        if(node == T_nil){
-            node = new Node(RED, {k, Value()}, T_nil, T_nil, pai);
-            while(!stack.empty()){
-                Node* aux = stack.top();
-                stack.pop();
-                insert_fixUp(aux);
-            }
-        }
-        return node->pair.second;
+        return _insert(k, Value())->pair.second;
     }
 
     const Value& operator[](const Key& k) const{
@@ -196,6 +199,7 @@ private:
 
         Node *_root; //no rais da arvore
         Node *T_nil; //no T_nil
+        size_t m_number_of_elements; //quantidade de pares
         mutable size_t compare_count; //contador de comparacoes
         mutable size_t rotate_count; //contador de comparacoes
 
@@ -204,11 +208,12 @@ private:
     * caminha pela arvore na direcao onde a chave estaria, se ela estiver presente
     * seu valor é atualizado, se nao um novo par eh criado e adicionado na posicao devida.
     * Apos eh chamado o fixUp para possiveis correcoes.
+    * Retorna o nodo que guarda a chave (o fixUp so troca ponteiros e cores, os pares nao mudam de nodo).
     * 
     * @param k := Chave a ser inserida.
     * @param v := Valor associado a chave.
     */
-    void _insert(Key k, Value v){
+    Node* _insert(const Key& k, const Value& v){
         Node* x = _root;
         Node* y = T_nil;
         while(x != T_nil){
@@ -221,11 +226,12 @@ private:
                 x = x->right;
             }else{
                 compare_count += 2;
-                return;
+                return x;
             }
         }
 
         Node* z = new Node(RED, {k, v}, T_nil, T_nil, y);
+        m_number_of_elements++;
         if(y == T_nil){
             _root = z;
             insert_fixUp(z);
@@ -237,6 +243,7 @@ private:
             insert_fixUp(z);
         }
         compare_count++;
+        return z;
     }
 
     /**
@@ -298,6 +305,7 @@ private:
             delete_fixUp(x);
         }
         delete y;
+        m_number_of_elements--;
     }
 
     /**
@@ -340,18 +348,6 @@ private:
         return false;
     }
 
-    /**
-    * @brief Recebe um nodo e conta quantos nos tem a partir dele.
-    * 
-    * @param node := no a partir do qual a contagem comeca.
-    */
-    int _size(Node* node){
-        if (node == T_nil)
-            return 0;
-
-        return _size(node->left) + _size(node->right) + 1;
-    }
-
     /**
     * @brief Recebe um nodo e retorna seu menor descendente.
     * 
@@ -527,7 +523,7 @@ private:
         node->parent = y;
     }
 
-    Value& _at(Node* node, Key k) {
+    Value& _at(Node* node, const Key& k) const{
         while(node != T_nil){
             if(node->pair.first == k){
                 return node->pair.second;
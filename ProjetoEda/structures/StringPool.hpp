@@ -0,0 +1,197 @@
+/**
+ * @file StringPool.hpp
+ * @author Paulo Henrique (phenriquedss@alu.ufc.br)
+ * @brief Arena de strings compartilhada pelos dicionarios
+ * Estrutura de dados avancada - 2025.1
+ * @version 0.1
+ * @date 2025-07-08
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef STRINGPOOL_HPP
+#define STRINGPOOL_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <functional>
+
+/**
+ * @brief Referencia compacta (ponteiro + tamanho) para uma string guardada em um StringPool.
+ *
+ * Ocupa 16 bytes e nao possui a memoria apontada: quem guarda a chave eh o pool,
+ * as estruturas guardam somente o handle. Pode tambem apontar temporariamente para
+ * uma std::string qualquer, o que eh usado nas buscas para nao copiar a chave.
+ */
+struct PooledString{
+    const char* m_data;
+    uint32_t m_length;
+
+    PooledString(){
+        m_data = "";
+        m_length = 0;
+    }
+
+    PooledString(const char* data, uint32_t length){
+        m_data = data;
+        m_length = length;
+    }
+
+    /**
+     * @brief Cria uma visao (sem copia) de uma std::string, valida enquanto s existir.
+     */
+    explicit PooledString(const std::string& s){
+        m_data = s.data();
+        m_length = static_cast<uint32_t>(s.size());
+    }
+
+    const char* data() const{
+        return m_data;
+    }
+
+    size_t size() const{
+        return m_length;
+    }
+
+    std::string_view view() const{
+        return std::string_view(m_data, m_length);
+    }
+
+    explicit operator std::string() const{
+        return std::string(m_data, m_length);
+    }
+
+    bool operator==(const PooledString& other) const{
+        return m_length == other.m_length && std::memcmp(m_data, other.m_data, m_length) == 0;
+    }
+
+    bool operator!=(const PooledString& other) const{
+        return !(*this == other);
+    }
+
+    bool operator<(const PooledString& other) const{
+        return view() < other.view();
+    }
+
+    bool operator>(const PooledString& other) const{
+        return other < *this;
+    }
+};
+
+namespace std{
+    template <>
+    struct hash<PooledString>{
+        size_t operator()(const PooledString& s) const{
+            return std::hash<std::string_view>()(s.view());
+        }
+    };
+}
+
+/**
+ * @brief Arena de strings: os bytes das chaves sao copiados para blocos grandes
+ * e contiguos, que so sao liberados no clear() ou na destruicao do pool.
+ * Os blocos nunca sao realocados, entao os handles continuam validos.
+ *
+ * A insercao eh feita em duas etapas: stage() copia a string para o fim do bloco
+ * atual sem reserva-la e commit() a torna permanente. Se a chave ja existia na
+ * estrutura basta nao chamar commit(), e o proximo stage() reaproveita o espaco.
+ */
+class StringPool{
+public:
+    StringPool(){
+        m_used = 0;
+        m_capacity = 0;
+        m_staged = 0;
+        m_bytes = 0;
+    }
+
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    /**
+     * @brief Copia s para o fim do bloco atual e retorna um handle para a copia.
+     * O espaco so fica reservado apos commit().
+     *
+     * @param s := string a ser copiada.
+     */
+    PooledString stage(std::string_view s){
+        if(m_used + s.size() > m_capacity){
+            size_t capacity = s.size() > BLOCK_SIZE ? s.size() : BLOCK_SIZE;
+            m_blocks.emplace_back(new char[capacity]);
+            m_capacity = capacity;
+            m_used = 0;
+        }
+        char* dest = m_blocks.back().get() + m_used;
+        std::memcpy(dest, s.data(), s.size());
+        m_staged = s.size();
+        return PooledString(dest, static_cast<uint32_t>(s.size()));
+    }
+
+    /**
+     * @brief Torna permanente a ultima string passada para stage().
+     */
+    void commit(){
+        m_used += m_staged;
+        m_bytes += m_staged;
+        m_staged = 0;
+    }
+
+    /**
+     * @brief Copia s para o pool de forma permanente.
+     *
+     * @param s := string a ser copiada.
+     */
+    PooledString intern(std::string_view s){
+        PooledString handle = stage(s);
+        commit();
+        return handle;
+    }
+
+    /**
+     * @brief Libera todos os blocos; os handles antigos deixam de ser validos.
+     */
+    void clear(){
+        m_blocks.clear();
+        m_used = 0;
+        m_capacity = 0;
+        m_staged = 0;
+        m_bytes = 0;
+    }
+
+    /**
+     * @brief Retorna a quantidade de bytes de chaves guardadas no pool.
+     */
+    size_t bytes() const{
+        return m_bytes;
+    }
+
+private:
+    // tamanho de cada bloco da arena
+    static const size_t BLOCK_SIZE = 1 << 16;
+
+    std::vector<std::unique_ptr<char[]>> m_blocks; // blocos alocados
+    size_t m_used;     // bytes reservados no bloco atual
+    size_t m_capacity; // tamanho do bloco atual
+    size_t m_staged;   // tamanho da ultima string passada para stage()
+    size_t m_bytes;    // total de bytes reservados
+};
+
+/**
+ * @brief Tipo usado pelas estruturas para guardar uma chave do tipo Key:
+ * std::string eh guardada como PooledString, os demais tipos como eles mesmos.
+ */
+template <typename Key>
+struct Interned{
+    using type = Key;
+};
+
+template <>
+struct Interned<std::string>{
+    using type = PooledString;
+};
+
+#endif // END of STRINGPOOL_HPP
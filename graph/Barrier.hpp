@@ -0,0 +1,52 @@
+#ifndef BARRIER_HPP
+#define BARRIER_HPP
+#include <mutex>
+#include <condition_variable>
+
+// Barreira reutilizavel para um numero fixo de threads, usada entre as fases
+// de ParallelBfs e DeltaStepping.
+//
+// A ultima thread a chegar zera o contador e avanca a geracao; as demais
+// esperam a geracao mudar, entao a mesma barreira pode ser usada de novo
+// logo em seguida sem que uma thread atrasada confunda duas passagens.
+class Barrier {
+public:
+    Barrier() {
+        m_threads = 1;
+        m_waiting = 0;
+        m_generation = 0;
+    }
+
+    Barrier(const Barrier&) = delete;
+    Barrier& operator=(const Barrier&) = delete;
+
+    // prepara a barreira para count threads; nenhuma pode estar esperando
+    void reset(unsigned count) {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_threads = count;
+        m_waiting = 0;
+        m_generation = 0;
+    }
+
+    // bloqueia ate que todas as threads tenham chegado
+    void wait() {
+        std::unique_lock<std::mutex> guard(m_lock);
+        unsigned generation = m_generation;
+        if(++m_waiting == m_threads) {
+            m_waiting = 0;
+            m_generation++;
+            m_cond.notify_all();
+        } else {
+            m_cond.wait(guard, [this, generation]() { return generation != m_generation; });
+        }
+    }
+
+private:
+    std::mutex m_lock;
+    std::condition_variable m_cond;
+    unsigned m_threads;
+    unsigned m_waiting;
+    unsigned m_generation;
+};
+
+#endif
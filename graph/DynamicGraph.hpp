@@ -0,0 +1,280 @@
+#ifndef DYNAMICGRAPH_HPP
+#define DYNAMICGRAPH_HPP
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <algorithm>
+#include <stdexcept>
+
+#include "Graph.hpp"
+#include "NameTable.hpp"
+
+// Grafo dirigido que aceita arestas novas entre as consultas.
+//
+// Os vizinhos de cada vertice ficam em uma lista de blocos de tamanho fixo
+// (CHUNK destinos por bloco, 64 bytes), alocados de um unico vetor: inserir
+// uma aresta escreve no ultimo bloco da origem ou encadeia um bloco novo,
+// em O(1) amortizado, sem reorganizar o grafo como o CSR do Graph exigiria.
+//
+// As consultas de alcancabilidade passam por um cache LRU que guarda, para
+// as ultimas origens consultadas, o conjunto (bitset) de vertices
+// alcancaveis. Uma consulta com a origem no cache eh um teste de bit; sem
+// ela, uma busca calcula o conjunto inteiro e o guarda. Quando a aresta
+// u -> v eh inserida, cada conjunto que contem u e nao contem v eh estendido
+// com uma busca a partir de v que so visita vertices fora do conjunto. Como
+// cada vertice entra no conjunto uma unica vez, o custo total dessas
+// extensoes para uma origem eh limitado pelo tamanho do grafo, entao as
+// insercoes nunca invalidam o cache.
+class DynamicGraph {
+public:
+    // id de um nome que nao esta no grafo
+    static constexpr uint32_t NONE = NameTable::NONE;
+
+    // numero de destinos por bloco (bloco de 64 bytes)
+    static constexpr uint32_t CHUNK = 14;
+
+    // cacheSources = 0 desliga o cache (toda consulta eh uma busca)
+    explicit DynamicGraph(size_t cacheSources = 64) {
+        m_capacity = cacheSources;
+        m_edges = 0;
+        m_epoch = 0;
+        m_hits = 0;
+        m_misses = 0;
+    }
+
+    // copia os vertices e as arestas de um Graph ja construido
+    explicit DynamicGraph(const Graph& g, size_t cacheSources = 64) : DynamicGraph(cacheSources) {
+        for(uint32_t v = 0; v < g.vertices(); v++) {
+            if(g.declared(v)) {
+                add_vertex(g.name(v));
+            } else {
+                intern(g.name(v));
+            }
+        }
+        for(uint32_t v = 0; v < g.vertices(); v++) {
+            for(uint32_t w : g.neighbors(v)) {
+                append(v, w);
+            }
+        }
+    }
+
+    // as chaves do hash map da NameTable apontam para seus nomes, entao o
+    // grafo nao eh copiavel
+    DynamicGraph(const DynamicGraph&) = delete;
+    DynamicGraph& operator=(const DynamicGraph&) = delete;
+
+    // declara um vertice (um vertice pode ter arestas de saida) e retorna seu id
+    uint32_t add_vertex(std::string_view name) {
+        uint32_t v = m_names.add_vertex(name);
+        grow();
+        return v;
+    }
+
+    // retorna o id de name, criando um vertice nao declarado se preciso
+    uint32_t intern(std::string_view name) {
+        uint32_t v = m_names.intern(name);
+        grow();
+        return v;
+    }
+
+    // retorna o id de name ou NONE
+    uint32_t id(std::string_view name) const {
+        return m_names.id(name);
+    }
+
+    // retorna true se o vertice v foi declarado com add_vertex
+    bool declared(uint32_t v) const {
+        return m_names.declared(v);
+    }
+
+    // retorna o nome do vertice v
+    const std::string& name(uint32_t v) const {
+        return m_names.name(v);
+    }
+
+    // acrescenta a aresta from -> to e atualiza os conjuntos do cache
+    void add_edge(uint32_t from, uint32_t to) {
+        append(from, to);
+        for(Entry& e : m_cache) {
+            if(test(e.reach, from) && !test(e.reach, to)) {
+                extend(e.reach, to);
+            }
+        }
+    }
+
+    // chama fn(w) para cada vizinho w de v, na ordem de insercao
+    template <typename Fn>
+    void for_each_neighbor(uint32_t v, Fn fn) const {
+        for(uint32_t c = m_head[v]; c != NONE; c = m_chunks[c].next) {
+            const Chunk& chunk = m_chunks[c];
+            for(uint32_t i = 0; i < chunk.size; i++) {
+                fn(chunk.targets[i]);
+            }
+        }
+    }
+
+    // retorna true se to eh alcancavel a partir de from
+    bool reaches(uint32_t from, uint32_t to) {
+        if(from == to) {
+            return true;
+        }
+        if(m_capacity == 0) {
+            return search(from, to);
+        }
+        auto it = m_where.find(from);
+        if(it != m_where.end()) {
+            m_hits++;
+            m_cache.splice(m_cache.begin(), m_cache, it->second);
+            return test(it->second->reach, to);
+        }
+        m_misses++;
+        if(m_cache.size() >= m_capacity) {
+            m_where.erase(m_cache.back().source);
+            m_cache.pop_back();
+        }
+        m_cache.push_front(Entry{from, std::vector<uint64_t>()});
+        m_where[from] = m_cache.begin();
+        std::vector<uint64_t>& reach = m_cache.front().reach;
+        extend(reach, from);
+        return test(reach, to);
+    }
+
+    // numero de vertices (declarados ou nao)
+    size_t vertices() const {
+        return m_names.size();
+    }
+
+    // numero de arestas
+    size_t edges() const {
+        return m_edges;
+    }
+
+    // consultas respondidas pelo cache / que precisaram de uma busca
+    size_t hits() const {
+        return m_hits;
+    }
+
+    size_t misses() const {
+        return m_misses;
+    }
+
+private:
+    // bloco de destinos de um vertice
+    struct Chunk {
+        uint32_t next;              // proximo bloco ou NONE
+        uint32_t size;              // destinos usados
+        uint32_t targets[CHUNK];
+    };
+
+    // origem do cache e seus vertices alcancaveis
+    struct Entry {
+        uint32_t source;
+        std::vector<uint64_t> reach; // bitset; bits alem do fim valem 0
+    };
+
+    NameTable m_names;                               // nome <-> id
+    std::vector<Chunk> m_chunks;                     // todos os blocos
+    std::vector<uint32_t> m_head;                    // primeiro bloco de cada vertice
+    std::vector<uint32_t> m_tail;                    // ultimo bloco de cada vertice
+    size_t m_edges;
+
+    size_t m_capacity;                               // origens no cache
+    std::list<Entry> m_cache;                        // da mais para a menos recente
+    std::unordered_map<uint32_t, std::list<Entry>::iterator> m_where; // origem -> entrada
+    size_t m_hits;
+    size_t m_misses;
+
+    std::vector<uint32_t> m_stamp;                   // visitados da busca sem cache
+    std::vector<uint32_t> m_stack;
+    uint32_t m_epoch;
+
+    static bool test(const std::vector<uint64_t>& bits, uint32_t v) {
+        return v / 64 < bits.size() && ((bits[v / 64] >> (v % 64)) & 1);
+    }
+
+    static void set(std::vector<uint64_t>& bits, uint32_t v) {
+        if(v / 64 >= bits.size()) {
+            bits.resize(v / 64 + 1, 0);
+        }
+        bits[v / 64] |= uint64_t(1) << (v % 64);
+    }
+
+    // estende as listas por vertice ate cobrir os ids de m_names
+    void grow() {
+        while(m_head.size() < m_names.size()) {
+            m_head.push_back(NONE);
+            m_tail.push_back(NONE);
+            m_stamp.push_back(0);
+        }
+    }
+
+    // insere to no fim da lista de blocos de from
+    void append(uint32_t from, uint32_t to) {
+        uint32_t c = m_tail[from];
+        if(c == NONE || m_chunks[c].size == CHUNK) {
+            uint32_t fresh = static_cast<uint32_t>(m_chunks.size());
+            m_chunks.push_back(Chunk{NONE, 0, {}});
+            if(c == NONE) {
+                m_head[from] = fresh;
+            } else {
+                m_chunks[c].next = fresh;
+            }
+            m_tail[from] = c = fresh;
+        }
+        Chunk& chunk = m_chunks[c];
+        chunk.targets[chunk.size++] = to;
+        m_edges++;
+    }
+
+    // acrescenta a reach tudo o que eh alcancavel a partir de v (v ja
+    // pode estar marcado), sem passar por vertices ja marcados
+    void extend(std::vector<uint64_t>& reach, uint32_t v) {
+        set(reach, v);
+        m_stack.clear();
+        m_stack.push_back(v);
+        while(!m_stack.empty()) {
+            uint32_t x = m_stack.back();
+            m_stack.pop_back();
+            for_each_neighbor(x, [&](uint32_t w) {
+                if(!test(reach, w)) {
+                    set(reach, w);
+                    m_stack.push_back(w);
+                }
+            });
+        }
+    }
+
+    // DFS de from ate to, usada quando o cache esta desligado
+    bool search(uint32_t from, uint32_t to) {
+        if(++m_epoch == 0) {
+            std::fill(m_stamp.begin(), m_stamp.end(), 0);
+            m_epoch = 1;
+        }
+        m_stack.clear();
+        m_stack.push_back(from);
+        m_stamp[from] = m_epoch;
+        while(!m_stack.empty()) {
+            uint32_t x = m_stack.back();
+            m_stack.pop_back();
+            for(uint32_t c = m_head[x]; c != NONE; c = m_chunks[c].next) {
+                const Chunk& chunk = m_chunks[c];
+                for(uint32_t i = 0; i < chunk.size; i++) {
+                    uint32_t w = chunk.targets[i];
+                    if(w == to) {
+                        return true;
+                    }
+                    if(m_stamp[w] != m_epoch) {
+                        m_stamp[w] = m_epoch;
+                        m_stack.push_back(w);
+                    }
+                }
+            }
+        }
+        return false;
+    }
+};
+
+#endif
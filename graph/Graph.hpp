@@ -0,0 +1,235 @@
+#ifndef GRAPH_HPP
+#define GRAPH_HPP
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <stdexcept>
+
+#include "NameTable.hpp"
+
+// Grafo dirigido com vertices identificados por nome.
+//
+// Cada nome eh convertido uma unica vez para um id denso de 32 bits pela
+// NameTable, que tambem guarda quais vertices foram declarados. As arestas sao acumuladas em uma lista e build() as
+// organiza em formato CSR (compressed sparse row): os vizinhos de v ficam
+// contiguos em m_targets[m_offsets[v] .. m_offsets[v+1]), entao percorrer os
+// vizinhos eh uma varredura sequencial e cada aresta ocupa so 4 bytes.
+// Se alguma aresta tem peso diferente de 1, os pesos ficam em m_weights,
+// paralelo a m_targets. O grafo reverso (arestas de entrada) eh mantido
+// junto, tambem em CSR, e refeito a cada build() ou assign().
+class Graph {
+public:
+    // id de um nome que nao esta no grafo
+    static const uint32_t NONE = NameTable::NONE;
+
+    // intervalo [first, last) de vizinhos de um vertice
+    struct Range {
+        const uint32_t* first;
+        const uint32_t* last;
+        const uint32_t* begin() const { return first; }
+        const uint32_t* end() const { return last; }
+        size_t size() const { return last - first; }
+    };
+
+    Graph() {
+        m_offsets.push_back(0);
+        m_built = true;
+    }
+
+    // as chaves do hash map da NameTable apontam para seus nomes, entao o
+    // grafo nao eh copiavel
+    Graph(const Graph&) = delete;
+    Graph& operator=(const Graph&) = delete;
+
+    // declara um vertice (um vertice pode ter arestas de saida) e retorna seu id
+    uint32_t add_vertex(std::string_view name) {
+        return m_names.add_vertex(name);
+    }
+
+    // retorna o id de name, criando um vertice nao declarado se preciso
+    uint32_t intern(std::string_view name) {
+        return m_names.intern(name);
+    }
+
+    // retorna o id de name ou NONE
+    uint32_t id(std::string_view name) const {
+        return m_names.id(name);
+    }
+
+    // retorna true se name foi declarado com add_vertex
+    bool declared(std::string_view name) const {
+        return m_names.declared(name);
+    }
+
+    // retorna true se o vertice v foi declarado com add_vertex
+    bool declared(uint32_t v) const {
+        return m_names.declared(v);
+    }
+
+    // retorna o nome do vertice v
+    const std::string& name(uint32_t v) const {
+        return m_names.name(v);
+    }
+
+    // acrescenta a aresta from -> to; ela so aparece em neighbors() apos build()
+    void add_edge(uint32_t from, uint32_t to, uint32_t weight = 1) {
+        m_pending.push_back({from, to, weight});
+        m_built = false;
+    }
+
+    // organiza as arestas pendentes (e as ja construidas) em CSR por
+    // counting sort: conta o grau de saida de cada vertice, acumula os
+    // graus em offsets e distribui os destinos. A ordem de insercao das
+    // arestas de um mesmo vertice eh mantida.
+    void build() {
+        if(m_built) {
+            return;
+        }
+        size_t n = m_names.size();
+        size_t old_edges = m_targets.size();
+        if(old_edges + m_pending.size() >= NONE) {
+            throw std::length_error("too many edges");
+        }
+
+        bool weighted = !m_weights.empty();
+        std::vector<uint32_t> offsets(n + 1, 0);
+        for(size_t v = 0; v + 1 < m_offsets.size(); v++) {
+            offsets[v + 1] += m_offsets[v + 1] - m_offsets[v];
+        }
+        for(const Edge& e : m_pending) {
+            offsets[e.from + 1]++;
+            weighted = weighted || e.weight != 1;
+        }
+        for(size_t v = 0; v < n; v++) {
+            offsets[v + 1] += offsets[v];
+        }
+
+        std::vector<uint32_t> targets(offsets[n]);
+        std::vector<uint32_t> weights(weighted ? offsets[n] : 0);
+        std::vector<uint32_t> next(offsets.begin(), offsets.end() - 1);
+        for(size_t v = 0; v + 1 < m_offsets.size(); v++) {
+            for(uint32_t i = m_offsets[v]; i < m_offsets[v + 1]; i++) {
+                if(weighted) {
+                    weights[next[v]] = m_weights.empty() ? 1 : m_weights[i];
+                }
+                targets[next[v]++] = m_targets[i];
+            }
+        }
+        for(const Edge& e : m_pending) {
+            if(weighted) {
+                weights[next[e.from]] = e.weight;
+            }
+            targets[next[e.from]++] = e.to;
+        }
+
+        m_offsets.swap(offsets);
+        m_targets.swap(targets);
+        m_weights.swap(weights);
+        std::vector<Edge>().swap(m_pending);
+        m_built = true;
+        reverse();
+    }
+
+    // substitui todas as arestas por um CSR ja montado (usado pelo Loader):
+    // offsets deve ter vertices() + 1 posicoes e weights deve ser vazio
+    // (todos os pesos 1) ou ter um peso por destino
+    void assign(std::vector<uint32_t>&& offsets, std::vector<uint32_t>&& targets,
+                std::vector<uint32_t>&& weights = std::vector<uint32_t>()) {
+        if(offsets.size() != m_names.size() + 1 || offsets.back() != targets.size()
+            || (!weights.empty() && weights.size() != targets.size())) {
+            throw std::invalid_argument("invalid CSR arrays");
+        }
+        m_offsets = std::move(offsets);
+        m_targets = std::move(targets);
+        m_weights = std::move(weights);
+        std::vector<Edge>().swap(m_pending);
+        m_built = true;
+        reverse();
+    }
+
+    // retorna os vizinhos de v (vazio para vertices criados depois do build)
+    Range neighbors(uint32_t v) const {
+        if(v + 1 >= m_offsets.size()) {
+            return Range{nullptr, nullptr};
+        }
+        const uint32_t* base = m_targets.data();
+        return Range{base + m_offsets[v], base + m_offsets[v + 1]};
+    }
+
+    // retorna os vertices com aresta para v (vazio para vertices criados
+    // depois do build)
+    Range in_neighbors(uint32_t v) const {
+        if(v + 1 >= m_inOffsets.size()) {
+            return Range{nullptr, nullptr};
+        }
+        const uint32_t* base = m_inSources.data();
+        return Range{base + m_inOffsets[v], base + m_inOffsets[v + 1]};
+    }
+
+    // pesos das arestas de v, na mesma ordem de neighbors(v), ou nullptr
+    // se o grafo nao tem pesos (todos 1)
+    const uint32_t* weights(uint32_t v) const {
+        if(m_weights.empty() || v + 1 >= m_offsets.size()) {
+            return nullptr;
+        }
+        return m_weights.data() + m_offsets[v];
+    }
+
+    // retorna true se alguma aresta tem peso diferente de 1
+    bool weighted() const {
+        return !m_weights.empty();
+    }
+
+    // numero de vertices (declarados ou nao)
+    size_t vertices() const {
+        return m_names.size();
+    }
+
+    // numero de arestas ja construidas
+    size_t edges() const {
+        return m_targets.size();
+    }
+
+private:
+    // aresta ainda fora do CSR
+    struct Edge {
+        uint32_t from;
+        uint32_t to;
+        uint32_t weight;
+    };
+
+    NameTable m_names;                               // nome <-> id
+    std::vector<uint32_t> m_offsets;                 // inicio dos vizinhos de cada vertice
+    std::vector<uint32_t> m_targets;                 // destinos das arestas
+    std::vector<uint32_t> m_weights;                 // pesos (vazio se todos 1)
+    std::vector<uint32_t> m_inOffsets;               // grafo reverso em CSR
+    std::vector<uint32_t> m_inSources;               // origens das arestas de entrada
+    std::vector<Edge> m_pending;                     // arestas ainda fora do CSR
+    bool m_built;                                    // nao ha arestas pendentes
+
+    // refaz o grafo reverso por counting sort sobre as arestas de saida;
+    // as origens de cada vertice ficam em ordem crescente
+    void reverse() {
+        size_t n = m_offsets.size() - 1;
+        std::vector<uint32_t> offsets(n + 1, 0);
+        for(uint32_t w : m_targets) {
+            offsets[w + 1]++;
+        }
+        for(size_t v = 0; v < n; v++) {
+            offsets[v + 1] += offsets[v];
+        }
+        std::vector<uint32_t> sources(m_targets.size());
+        std::vector<uint32_t> next(offsets.begin(), offsets.end() - 1);
+        for(size_t v = 0; v < n; v++) {
+            for(uint32_t i = m_offsets[v]; i < m_offsets[v + 1]; i++) {
+                sources[next[m_targets[i]]++] = static_cast<uint32_t>(v);
+            }
+        }
+        m_inOffsets.swap(offsets);
+        m_inSources.swap(sources);
+    }
+};
+
+#endif
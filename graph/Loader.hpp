@@ -0,0 +1,493 @@
+#ifndef LOADER_HPP
+#define LOADER_HPP
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Graph.hpp"
+#include "Parallel.hpp"
+
+// Carregamento rapido de grafos.
+//
+// Formato texto (o mesmo lido por main.cpp):
+//   numero de vertices, nomes dos vertices,
+//   numero de relacoes, pares "origem destino" (ou triplas
+//   "origem destino peso" se weighted),
+//   numero de consultas, pares "a b" (ou, no modo dinamico, numero de
+//   comandos, triplas "put a b" / "has a b").
+// A entrada eh mapeada com mmap (ou lida de uma vez, se for um pipe) e os
+// tokens sao separados por um scanner proprio, sem iostream. As arestas sao
+// montadas direto em CSR em duas passadas: a primeira conta o grau de cada
+// origem, a segunda coloca cada destino na sua posicao. Com mais de uma
+// thread a secao de arestas eh dividida em blocos de pares e os contadores
+// sao atomicos; nesse caso a ordem dos vizinhos de um vertice pode variar.
+//
+// Formato binario (lista de arestas), com inteiros na ordem da maquina:
+//   Header                        40 bytes
+//   uint64_t name_offsets[n + 1]  inicio de cada nome no blob
+//   uint32_t edges[2 * m]         pares (origem, destino) por id
+//   uint32_t weights[m]           pesos, so com FLAG_WEIGHTED
+//   uint8_t  declared[n]          1 se o vertice foi declarado
+//   char     blob[]               nomes concatenados
+namespace loader {
+
+    static const char MAGIC[8] = {'E', 'D', 'A', 'G', 'R', 'A', 'F', '\0'};
+    static const uint32_t VERSION = 1;
+
+    // bits de Header::flags
+    static const uint64_t FLAG_WEIGHTED = 1;
+
+    // cabecalho do formato binario
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t vertices;
+        uint64_t edges;
+        uint64_t blob_size;
+        uint64_t flags;       // bits FLAG_*
+    };
+
+    // par de nomes de uma consulta; aponta para dentro da Input
+    struct Query {
+        std::string_view a;
+        std::string_view b;
+    };
+
+    // comando do modo dinamico: "put a b" insere a aresta a -> b e
+    // "has a b" consulta se b eh alcancavel a partir de a
+    struct Command {
+        bool put;
+        std::string_view a;
+        std::string_view b;
+    };
+
+    // conteudo de um arquivo (ou da entrada padrao, com path "-")
+    class Input {
+    public:
+        explicit Input(const std::string& path) {
+            m_data = nullptr;
+            m_size = 0;
+            m_mapped = false;
+            int fd = path == "-" ? 0 : ::open(path.c_str(), O_RDONLY);
+            if(fd < 0) {
+                throw std::runtime_error("Não foi possível abrir " + path);
+            }
+            struct stat st;
+            if(::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+                void* base = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if(base != MAP_FAILED) {
+                    ::madvise(base, st.st_size, MADV_SEQUENTIAL);
+                    m_data = static_cast<const char*>(base);
+                    m_size = st.st_size;
+                    m_mapped = true;
+                }
+            }
+            if(!m_mapped) {
+                // pipe ou arquivo que nao pode ser mapeado: le tudo
+                char chunk[1 << 16];
+                ssize_t got;
+                while((got = ::read(fd, chunk, sizeof(chunk))) > 0) {
+                    m_buffer.append(chunk, got);
+                }
+                m_data = m_buffer.data();
+                m_size = m_buffer.size();
+            }
+            if(fd != 0) {
+                ::close(fd);
+            }
+        }
+
+        ~Input() {
+            if(m_mapped) {
+                ::munmap(const_cast<char*>(m_data), m_size);
+            }
+        }
+
+        Input(const Input&) = delete;
+        Input& operator=(const Input&) = delete;
+
+        const char* data() const { return m_data; }
+        size_t size() const { return m_size; }
+
+    private:
+        const char* m_data;
+        size_t m_size;
+        bool m_mapped;
+        std::string m_buffer;
+    };
+
+    // separa tokens delimitados por espaco em branco
+    class Scanner {
+    public:
+        Scanner(const char* begin, const char* end) {
+            m_pos = begin;
+            m_end = end;
+        }
+
+        // le o proximo token; retorna false no fim da entrada
+        bool token(std::string_view& out) {
+            while(m_pos < m_end && space(*m_pos)) {
+                m_pos++;
+            }
+            if(m_pos == m_end) {
+                return false;
+            }
+            const char* start = m_pos;
+            while(m_pos < m_end && !space(*m_pos)) {
+                m_pos++;
+            }
+            out = std::string_view(start, m_pos - start);
+            return true;
+        }
+
+        // le o proximo token exigindo que ele exista
+        std::string_view next() {
+            std::string_view out;
+            if(!token(out)) {
+                throw std::runtime_error("Entrada incompleta");
+            }
+            return out;
+        }
+
+        // le um inteiro sem sinal
+        uint64_t number() {
+            std::string_view t = next();
+            uint64_t value = 0;
+            for(char c : t) {
+                if(c < '0' || c > '9') {
+                    throw std::runtime_error("Numero invalido: " + std::string(t));
+                }
+                value = value * 10 + (c - '0');
+            }
+            return value;
+        }
+
+        // pula count tokens
+        void skip(uint64_t count) {
+            for(uint64_t i = 0; i < count; i++) {
+                next();
+            }
+        }
+
+        const char* position() const {
+            return m_pos;
+        }
+
+    private:
+        const char* m_pos;
+        const char* m_end;
+
+        static bool space(char c) {
+            return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+        }
+    };
+
+    // converte t em um peso de 32 bits; retorna false se t nao eh valido
+    inline bool parse_weight(std::string_view t, uint32_t& out) {
+        uint64_t value = 0;
+        if(t.empty() || t.size() > 10) {
+            return false;
+        }
+        for(char c : t) {
+            if(c < '0' || c > '9') {
+                return false;
+            }
+            value = value * 10 + (c - '0');
+        }
+        if(value > UINT32_MAX) {
+            return false;
+        }
+        out = static_cast<uint32_t>(value);
+        return true;
+    }
+
+    // soma de prefixos dos graus em offsets com vertices + 1 posicoes
+    inline std::vector<uint32_t> prefix(const std::vector<std::atomic<uint32_t>>& degree, size_t vertices) {
+        std::vector<uint32_t> offsets(vertices + 1, 0);
+        uint64_t total = 0;
+        for(size_t v = 0; v < vertices; v++) {
+            offsets[v] = static_cast<uint32_t>(total);
+            if(v < degree.size()) {
+                total += degree[v].load(std::memory_order_relaxed);
+            }
+            if(total >= Graph::NONE) {
+                throw std::length_error("too many edges");
+            }
+        }
+        offsets[vertices] = static_cast<uint32_t>(total);
+        return offsets;
+    }
+
+    // le consultas "quantidade a b a b ..." a partir de scanner
+    inline void read_queries(Scanner& scanner, std::vector<Query>& queries) {
+        std::string_view t;
+        if(!scanner.token(t)) {
+            return; // sem secao de consultas
+        }
+        Scanner count(t.data(), t.data() + t.size());
+        uint64_t n = count.number();
+        queries.reserve(queries.size() + (n < (1u << 20) ? n : (1u << 20)));
+        for(uint64_t i = 0; i < n; i++) {
+            std::string_view a = scanner.next();
+            std::string_view b = scanner.next();
+            queries.push_back({a, b});
+        }
+    }
+
+    // le comandos "quantidade op a b op a b ..." a partir de scanner
+    inline void read_commands(Scanner& scanner, std::vector<Command>& commands) {
+        std::string_view t;
+        if(!scanner.token(t)) {
+            return; // sem secao de comandos
+        }
+        Scanner count(t.data(), t.data() + t.size());
+        uint64_t n = count.number();
+        commands.reserve(commands.size() + (n < (1u << 20) ? n : (1u << 20)));
+        for(uint64_t i = 0; i < n; i++) {
+            std::string_view op = scanner.next();
+            if(op != "put" && op != "has") {
+                throw std::runtime_error("Comando invalido: " + std::string(op));
+            }
+            std::string_view a = scanner.next();
+            std::string_view b = scanner.next();
+            commands.push_back({op == "put", a, b});
+        }
+    }
+
+    // le as secoes de vertices e arestas do formato texto para g (que deve
+    // estar vazio), deixando scanner no inicio da secao seguinte; com
+    // weighted cada relacao tem um terceiro campo, o peso (inteiro de 32
+    // bits sem sinal)
+    inline void read_graph(Scanner& scanner, Graph& g, unsigned threads = 1, bool weighted = false) {
+        uint64_t nv = scanner.number();
+        for(uint64_t i = 0; i < nv; i++) {
+            g.add_vertex(scanner.next());
+        }
+        size_t declared = g.vertices();
+
+        // limites dos blocos de pares de cada thread
+        uint64_t ne = scanner.number();
+        if(threads == 0) {
+            threads = 1;
+        }
+        if(ne / threads < 4096) {
+            threads = static_cast<unsigned>(ne / 4096 + 1);
+        }
+        unsigned fields = weighted ? 3 : 2;
+        std::vector<const char*> bound(threads + 1);
+        std::vector<uint64_t> pairs(threads);
+        bound[0] = scanner.position();
+        for(unsigned t = 0; t < threads; t++) {
+            pairs[t] = ne * (t + 1) / threads - ne * t / threads;
+            scanner.skip(fields * pairs[t]);
+            bound[t + 1] = scanner.position();
+        }
+
+        // primeira passada: graus das origens e destinos ainda sem id
+        std::vector<std::atomic<uint32_t>> degree(declared);
+        std::vector<std::vector<std::string_view>> unknown(threads);
+        std::atomic<bool> invalid(false);
+        parallel(threads, [&](unsigned t) {
+            Scanner chunk(bound[t], bound[t + 1]);
+            uint32_t weight;
+            for(uint64_t i = 0; i < pairs[t]; i++) {
+                uint32_t from = g.id(chunk.next());
+                std::string_view to = chunk.next();
+                if(weighted && !parse_weight(chunk.next(), weight)) {
+                    invalid = true;
+                    return;
+                }
+                if(from == Graph::NONE) {
+                    continue; // a origem precisa ser um vertice declarado
+                }
+                degree[from].fetch_add(1, std::memory_order_relaxed);
+                if(g.id(to) == Graph::NONE) {
+                    unknown[t].push_back(to);
+                }
+            }
+        });
+        if(invalid) {
+            throw std::runtime_error("Peso invalido");
+        }
+        for(const auto& names : unknown) {
+            for(std::string_view name : names) {
+                g.intern(name);
+            }
+        }
+        std::vector<std::vector<std::string_view>>().swap(unknown);
+
+        // segunda passada: cada destino vai para a proxima posicao da origem
+        std::vector<uint32_t> offsets = prefix(degree, g.vertices());
+        std::vector<uint32_t> targets(offsets.back());
+        std::vector<uint32_t> weights(weighted ? offsets.back() : 0);
+        for(size_t v = 0; v < declared; v++) {
+            degree[v].store(offsets[v], std::memory_order_relaxed);
+        }
+        parallel(threads, [&](unsigned t) {
+            Scanner chunk(bound[t], bound[t + 1]);
+            uint32_t weight = 1;
+            for(uint64_t i = 0; i < pairs[t]; i++) {
+                uint32_t from = g.id(chunk.next());
+                std::string_view to = chunk.next();
+                if(weighted) {
+                    parse_weight(chunk.next(), weight); // ja validado
+                }
+                if(from >= declared) {
+                    continue; // nao declarado (ou NONE)
+                }
+                uint32_t pos = degree[from].fetch_add(1, std::memory_order_relaxed);
+                targets[pos] = g.id(to);
+                if(weighted) {
+                    weights[pos] = weight;
+                }
+            }
+        });
+        g.assign(std::move(offsets), std::move(targets), std::move(weights));
+    }
+
+    // le o formato texto: vertices e arestas vao para g (que deve estar
+    // vazio) e as consultas para queries
+    inline void read_text(const Input& in, Graph& g, std::vector<Query>& queries, unsigned threads = 1,
+                          bool weighted = false) {
+        Scanner scanner(in.data(), in.data() + in.size());
+        read_graph(scanner, g, threads, weighted);
+        read_queries(scanner, queries);
+    }
+
+    // grava g no formato binario
+    inline void write_binary(const std::string& path, const Graph& g) {
+        Header header;
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.vertices = static_cast<uint32_t>(g.vertices());
+        header.edges = g.edges();
+        header.blob_size = 0;
+        header.flags = g.weighted() ? FLAG_WEIGHTED : 0;
+
+        std::vector<uint64_t> names;
+        std::vector<uint8_t> declared;
+        names.reserve(g.vertices() + 1);
+        for(uint32_t v = 0; v < header.vertices; v++) {
+            names.push_back(header.blob_size);
+            header.blob_size += g.name(v).size();
+            declared.push_back(g.declared(v) ? 1 : 0);
+        }
+        names.push_back(header.blob_size);
+        std::vector<uint32_t> edges;
+        std::vector<uint32_t> weights;
+        edges.reserve(2 * g.edges());
+        for(uint32_t v = 0; v < header.vertices; v++) {
+            for(uint32_t w : g.neighbors(v)) {
+                edges.push_back(v);
+                edges.push_back(w);
+            }
+            if(g.weighted()) {
+                const uint32_t* ws = g.weights(v);
+                weights.insert(weights.end(), ws, ws + g.neighbors(v).size());
+            }
+        }
+
+        std::string tmp = path + ".tmp";
+        FILE* file = std::fopen(tmp.c_str(), "wb");
+        if(file == nullptr) {
+            throw std::runtime_error("Não foi possível criar " + tmp);
+        }
+        bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+        ok = ok && std::fwrite(names.data(), sizeof(uint64_t), names.size(), file) == names.size();
+        ok = ok && (edges.empty() || std::fwrite(edges.data(), sizeof(uint32_t), edges.size(), file) == edges.size());
+        ok = ok && (weights.empty() || std::fwrite(weights.data(), sizeof(uint32_t), weights.size(), file) == weights.size());
+        ok = ok && (declared.empty() || std::fwrite(declared.data(), 1, declared.size(), file) == declared.size());
+        for(uint32_t v = 0; v < header.vertices && ok; v++) {
+            ok = std::fwrite(g.name(v).data(), 1, g.name(v).size(), file) == g.name(v).size();
+        }
+        ok = (std::fclose(file) == 0) && ok;
+        if(!ok || std::rename(tmp.c_str(), path.c_str()) != 0) {
+            std::remove(tmp.c_str());
+            throw std::runtime_error("Erro ao escrever " + path);
+        }
+    }
+
+    // le o formato binario para g (que deve estar vazio)
+    inline void read_binary(const std::string& path, Graph& g, unsigned threads = 1) {
+        Input in(path);
+        const Header* header = reinterpret_cast<const Header*>(in.data());
+        if(in.size() < sizeof(Header) || std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0
+            || header->version != VERSION || header->edges > in.size() || header->blob_size > in.size()) {
+            throw std::runtime_error("Grafo binario invalido: " + path);
+        }
+        bool weighted = (header->flags & FLAG_WEIGHTED) != 0;
+        uint64_t n = header->vertices;
+        uint64_t m = header->edges;
+        uint64_t expected = sizeof(Header) + (n + 1) * sizeof(uint64_t)
+            + (weighted ? 3 : 2) * m * sizeof(uint32_t) + n + header->blob_size;
+        if(expected != in.size()) {
+            throw std::runtime_error("Grafo binario invalido: " + path);
+        }
+        const uint64_t* names = reinterpret_cast<const uint64_t*>(in.data() + sizeof(Header));
+        const uint32_t* edges = reinterpret_cast<const uint32_t*>(names + n + 1);
+        const uint32_t* edge_weights = edges + 2 * m;
+        const uint8_t* declared = reinterpret_cast<const uint8_t*>(edge_weights + (weighted ? m : 0));
+        const char* blob = reinterpret_cast<const char*>(declared + n);
+
+        for(uint64_t v = 0; v < n; v++) {
+            if(names[v] > names[v + 1] || names[v + 1] > header->blob_size) {
+                throw std::runtime_error("Grafo binario invalido: " + path);
+            }
+            std::string_view name(blob + names[v], names[v + 1] - names[v]);
+            uint32_t id = declared[v] ? g.add_vertex(name) : g.intern(name);
+            if(id != v) {
+                throw std::runtime_error("Nome repetido no grafo binario: " + std::string(name));
+            }
+        }
+
+        if(threads == 0) {
+            threads = 1;
+        }
+        if(m / threads < 4096) {
+            threads = static_cast<unsigned>(m / 4096 + 1);
+        }
+        std::vector<std::atomic<uint32_t>> degree(n);
+        std::atomic<bool> invalid(false);
+        parallel(threads, [&](unsigned t) {
+            for(uint64_t i = m * t / threads; i < m * (t + 1) / threads; i++) {
+                if(edges[2 * i] >= n || edges[2 * i + 1] >= n) {
+                    invalid = true;
+                    return;
+                }
+                degree[edges[2 * i]].fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+        if(invalid) {
+            throw std::runtime_error("Grafo binario invalido: " + path);
+        }
+        std::vector<uint32_t> offsets = prefix(degree, n);
+        std::vector<uint32_t> targets(offsets.back());
+        std::vector<uint32_t> weights(weighted ? offsets.back() : 0);
+        for(uint64_t v = 0; v < n; v++) {
+            degree[v].store(offsets[v], std::memory_order_relaxed);
+        }
+        parallel(threads, [&](unsigned t) {
+            for(uint64_t i = m * t / threads; i < m * (t + 1) / threads; i++) {
+                uint32_t pos = degree[edges[2 * i]].fetch_add(1, std::memory_order_relaxed);
+                targets[pos] = edges[2 * i + 1];
+                if(weighted) {
+                    weights[pos] = edge_weights[i];
+                }
+            }
+        });
+        g.assign(std::move(offsets), std::move(targets), std::move(weights));
+    }
+}
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef NAMETABLE_HPP
+#define NAMETABLE_HPP
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <stdexcept>
+
+// Tabela de nomes de vertices usada por Graph e DynamicGraph.
+//
+// Cada nome eh convertido uma unica vez (por um hash map) para um id denso
+// de 32 bits. Os nomes ficam em um deque, que nunca move seus elementos,
+// entao o hash map pode usar string_view como chave e as buscas nao copiam
+// a string procurada. Para cada id a tabela guarda tambem se o vertice foi
+// declarado (pode ter arestas de saida) ou so apareceu como destino.
+class NameTable {
+public:
+    // id de um nome que nao esta na tabela
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    NameTable() {
+    }
+
+    // as chaves do hash map apontam para m_names, entao a tabela nao eh copiavel
+    NameTable(const NameTable&) = delete;
+    NameTable& operator=(const NameTable&) = delete;
+
+    // declara name e retorna seu id
+    uint32_t add_vertex(std::string_view name) {
+        uint32_t v = intern(name);
+        m_declared[v] = true;
+        return v;
+    }
+
+    // retorna o id de name, criando um id nao declarado se preciso
+    uint32_t intern(std::string_view name) {
+        auto it = m_ids.find(name);
+        if(it != m_ids.end()) {
+            return it->second;
+        }
+        if(m_names.size() >= NONE) {
+            throw std::length_error("too many vertices");
+        }
+        uint32_t v = static_cast<uint32_t>(m_names.size());
+        m_names.emplace_back(name);
+        m_ids.emplace(m_names.back(), v);
+        m_declared.push_back(false);
+        return v;
+    }
+
+    // retorna o id de name ou NONE
+    uint32_t id(std::string_view name) const {
+        auto it = m_ids.find(name);
+        return it == m_ids.end() ? NONE : it->second;
+    }
+
+    // retorna true se name foi declarado com add_vertex
+    bool declared(std::string_view name) const {
+        uint32_t v = id(name);
+        return v != NONE && m_declared[v];
+    }
+
+    // retorna true se o id v foi declarado com add_vertex
+    bool declared(uint32_t v) const {
+        return m_declared[v];
+    }
+
+    // retorna o nome do id v
+    const std::string& name(uint32_t v) const {
+        return m_names[v];
+    }
+
+    // numero de ids (declarados ou nao)
+    size_t size() const {
+        return m_names.size();
+    }
+
+private:
+    std::unordered_map<std::string_view, uint32_t> m_ids; // nome -> id
+    std::deque<std::string> m_names;                 // id -> nome
+    std::vector<bool> m_declared;                    // id declarado
+};
+
+#endif
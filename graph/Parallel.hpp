@@ -0,0 +1,20 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+#include <vector>
+#include <thread>
+
+// executa fn(t) para t em [0, threads), cada parte em uma thread; a thread
+// atual faz a parte 0 e espera as demais (usado por Loader e UnionFind)
+template <typename Fn>
+void parallel(unsigned threads, Fn fn) {
+    std::vector<std::thread> pool;
+    for(unsigned t = 1; t < threads; t++) {
+        pool.emplace_back(fn, t);
+    }
+    fn(0);
+    for(std::thread& th : pool) {
+        th.join();
+    }
+}
+
+#endif
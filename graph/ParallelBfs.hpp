@@ -0,0 +1,265 @@
+#ifndef PARALLELBFS_HPP
+#define PARALLELBFS_HPP
+#include <cstdint>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <functional>
+#include <algorithm>
+
+#include "Graph.hpp"
+#include "Barrier.hpp"
+
+// BFS paralela com otimizacao de direcao (Beamer et al.).
+//
+// Cada nivel eh expandido por todas as threads, de um de dois modos:
+//  - top-down: cada vertice da fronteira examina seus vizinhos de saida e
+//    reivindica os nao visitados com fetch_or no bitmap de visitados;
+//  - bottom-up: cada vertice ainda nao visitado examina seus vizinhos de
+//    entrada (Graph::in_neighbors) e para no primeiro que esta na fronteira.
+// Top-down eh melhor com fronteiras pequenas; bottom-up quando a fronteira
+// cobre boa parte das arestas, porque cada vertice para no primeiro pai. A
+// troca segue a heuristica do artigo: vai para bottom-up quando as arestas
+// saindo da fronteira (mf) passam de mu / ALPHA, com mu as arestas dos
+// vertices ainda nao visitados, e volta para top-down quando a fronteira
+// tem menos de n / BETA vertices.
+//
+// A fronteira eh mantida nas duas formas (fila e bitmap). Os vertices
+// descobertos por uma thread vao para um buffer local, copiado para a fila
+// do proximo nivel com uma unica reserva atomica. As threads sao criadas uma
+// vez por busca e sincronizadas por uma barreira a cada nivel.
+class ParallelBfs {
+public:
+    // distancia de um vertice nao alcancado
+    static constexpr uint32_t UNREACHED = UINT32_MAX;
+
+    // threads = 0 usa std::thread::hardware_concurrency()
+    explicit ParallelBfs(const Graph& g, unsigned threads = 0) : m_graph(g) {
+        m_threads = threads != 0 ? threads : std::thread::hardware_concurrency();
+        if(m_threads == 0) {
+            m_threads = 1;
+        }
+        m_n = static_cast<uint32_t>(g.vertices());
+        m_words = (m_n + 63) / 64;
+        m_visited = std::vector<std::atomic<uint64_t>>(m_words);
+        m_front = std::vector<std::atomic<uint64_t>>(m_words);
+        m_next = std::vector<std::atomic<uint64_t>>(m_words);
+        m_queue.resize(m_n);
+        m_nextQueue.resize(m_n);
+        m_dist.assign(m_n, UNREACHED);
+    }
+
+    // distancias (em arestas) de source a todos os vertices
+    const std::vector<uint32_t>& distances(uint32_t source) {
+        run(source, UNREACHED);
+        return m_dist;
+    }
+
+    // distancia de from a to, ou UNREACHED; para no nivel em que to eh
+    // descoberto
+    uint32_t distance(uint32_t from, uint32_t to) {
+        if(from == to) {
+            return 0;
+        }
+        run(from, to);
+        return m_dist[to];
+    }
+
+    // retorna true se to eh alcancavel a partir de from
+    bool reaches(uint32_t from, uint32_t to) {
+        return distance(from, to) != UNREACHED;
+    }
+
+    // niveis expandidos de baixo para cima na ultima busca
+    unsigned bottom_up_levels() const {
+        return m_bottomUpLevels;
+    }
+
+private:
+    // constantes da heuristica de troca de direcao (valores do artigo)
+    static constexpr uint32_t ALPHA = 14;
+    static constexpr uint32_t BETA = 24;
+
+    // tamanho dos blocos distribuidos entre as threads
+    static constexpr uint32_t CHUNK = 256;
+
+    const Graph& m_graph;
+    unsigned m_threads;
+    uint32_t m_n;
+    size_t m_words;
+
+    std::vector<std::atomic<uint64_t>> m_visited; // vertices ja descobertos
+    std::vector<std::atomic<uint64_t>> m_front;   // fronteira atual
+    std::vector<std::atomic<uint64_t>> m_next;    // proxima fronteira
+    std::vector<uint32_t> m_queue;      // fronteira atual (fila)
+    std::vector<uint32_t> m_nextQueue;  // proxima fronteira (fila)
+    uint32_t m_queueSize;
+    std::atomic<uint32_t> m_nextSize;
+    std::atomic<uint64_t> m_nextEdges;  // arestas de saida da proxima fronteira
+    std::atomic<uint32_t> m_cursor;     // proximo bloco a ser processado
+    std::vector<uint32_t> m_dist;
+
+    uint32_t m_target;
+    uint32_t m_level;
+    bool m_bottomUp;
+    bool m_done;
+    uint64_t m_unexplored;              // mu: arestas de saida dos nao visitados
+    unsigned m_bottomUpLevels;
+
+    Barrier m_barrier;                  // separa as fases das threads
+
+    static bool test(const std::vector<std::atomic<uint64_t>>& bits, uint32_t v) {
+        return (bits[v / 64].load(std::memory_order_relaxed) >> (v % 64)) & 1;
+    }
+
+    // marca v e retorna true se o bit estava desligado
+    static bool claim(std::vector<std::atomic<uint64_t>>& bits, uint32_t v) {
+        uint64_t mask = uint64_t(1) << (v % 64);
+        return !(bits[v / 64].fetch_or(mask, std::memory_order_relaxed) & mask);
+    }
+
+    static void clear(std::vector<std::atomic<uint64_t>>& bits) {
+        for(auto& word : bits) {
+            word.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // registra a descoberta de v no nivel seguinte
+    void discover(uint32_t v, std::vector<uint32_t>& local, uint64_t& edges) {
+        m_dist[v] = m_level + 1;
+        claim(m_next, v);
+        local.push_back(v);
+        edges += m_graph.neighbors(v).size();
+    }
+
+    // top-down: blocos da fila da fronteira
+    void topDown(std::vector<uint32_t>& local, uint64_t& edges) {
+        while(true) {
+            uint32_t begin = m_cursor.fetch_add(CHUNK, std::memory_order_relaxed);
+            if(begin >= m_queueSize) {
+                break;
+            }
+            uint32_t end = begin + CHUNK < m_queueSize ? begin + CHUNK : m_queueSize;
+            for(uint32_t i = begin; i < end; i++) {
+                for(uint32_t w : m_graph.neighbors(m_queue[i])) {
+                    if(!test(m_visited, w) && claim(m_visited, w)) {
+                        discover(w, local, edges);
+                    }
+                }
+            }
+        }
+    }
+
+    // bottom-up: blocos de CHUNK vertices (multiplo de 64, entao cada
+    // palavra dos bitmaps eh escrita por uma unica thread)
+    void bottomUp(std::vector<uint32_t>& local, uint64_t& edges) {
+        while(true) {
+            uint32_t begin = m_cursor.fetch_add(CHUNK, std::memory_order_relaxed);
+            if(begin >= m_n) {
+                break;
+            }
+            uint32_t end = begin + CHUNK < m_n ? begin + CHUNK : m_n;
+            for(uint32_t v = begin; v < end; v++) {
+                if(test(m_visited, v)) {
+                    continue;
+                }
+                for(uint32_t u : m_graph.in_neighbors(v)) {
+                    if(test(m_front, u)) {
+                        claim(m_visited, v);
+                        discover(v, local, edges);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    // fecha o nivel (executado por uma unica thread entre duas barreiras)
+    void finishLevel() {
+        uint32_t size = m_nextSize.load(std::memory_order_relaxed);
+        uint64_t mf = m_nextEdges.load(std::memory_order_relaxed);
+        m_unexplored -= mf;
+        m_queue.swap(m_nextQueue);
+        m_queueSize = size;
+        m_front.swap(m_next);
+        clear(m_next);
+        m_nextSize.store(0, std::memory_order_relaxed);
+        m_nextEdges.store(0, std::memory_order_relaxed);
+        m_cursor.store(0, std::memory_order_relaxed);
+        m_level++;
+
+        if(size == 0 || (m_target != UNREACHED && m_dist[m_target] != UNREACHED)) {
+            m_done = true;
+            return;
+        }
+        if(!m_bottomUp && mf > m_unexplored / ALPHA) {
+            m_bottomUp = true;
+        } else if(m_bottomUp && size < m_n / BETA) {
+            m_bottomUp = false;
+        }
+    }
+
+    // corpo de cada thread: expande niveis ate a busca terminar
+    void worker(unsigned id) {
+        std::vector<uint32_t> local;
+        while(true) {
+            local.clear();
+            uint64_t edges = 0;
+            if(m_bottomUp) {
+                bottomUp(local, edges);
+            } else {
+                topDown(local, edges);
+            }
+            if(!local.empty()) {
+                uint32_t pos = m_nextSize.fetch_add(static_cast<uint32_t>(local.size()), std::memory_order_relaxed);
+                std::copy(local.begin(), local.end(), m_nextQueue.begin() + pos);
+                m_nextEdges.fetch_add(edges, std::memory_order_relaxed);
+            }
+            m_barrier.wait();
+            if(id == 0) {
+                if(m_bottomUp) {
+                    m_bottomUpLevels++;
+                }
+                finishLevel();
+            }
+            m_barrier.wait();
+            if(m_done) {
+                break;
+            }
+        }
+    }
+
+    // prepara o estado e executa a busca a partir de source
+    void run(uint32_t source, uint32_t target) {
+        std::fill(m_dist.begin(), m_dist.end(), UNREACHED);
+        clear(m_visited);
+        clear(m_front);
+        clear(m_next);
+        m_target = target;
+        m_level = 0;
+        m_bottomUp = false;
+        m_done = false;
+        m_bottomUpLevels = 0;
+        m_unexplored = m_graph.edges() - m_graph.neighbors(source).size();
+        m_dist[source] = 0;
+        claim(m_visited, source);
+        claim(m_front, source);
+        m_queue[0] = source;
+        m_queueSize = 1;
+        m_nextSize = 0;
+        m_nextEdges = 0;
+        m_cursor = 0;
+        m_barrier.reset(m_threads);
+
+        std::vector<std::thread> pool;
+        for(unsigned id = 1; id < m_threads; id++) {
+            pool.emplace_back(&ParallelBfs::worker, this, id);
+        }
+        worker(0);
+        for(std::thread& t : pool) {
+            t.join();
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,290 @@
+#ifndef REACHINDEX_HPP
+#define REACHINDEX_HPP
+#include <cstdint>
+#include <vector>
+#include <random>
+#include <algorithm>
+
+#include "Graph.hpp"
+
+// Indice de alcancabilidade para um grafo estatico.
+//
+// 1. As componentes fortemente conexas sao encontradas com Tarjan (iterativo)
+//    e o grafo eh condensado em um DAG. Tarjan numera as componentes em ordem
+//    topologica reversa, entao se a alcanca b entao comp(a) >= comp(b).
+// 2. Sobre o DAG:
+//    - com poucas componentes (ate MAX_CLOSURE) eh guardado o fecho
+//      transitivo completo, um bitset por componente, calculado com OR de
+//      palavras de 64 bits; a consulta eh um teste de bit;
+//    - senao sao calculados K rotulos de intervalos GRAIL (DFS com ordem de
+//      filhos aleatoria). Se o intervalo de b nao esta contido no de a em
+//      algum rotulo, b nao eh alcancavel; caso contrario uma DFS no DAG
+//      responde, descartando os filhos cujo intervalo nao contem o de b.
+class ReachIndex {
+public:
+    // numero maximo de componentes para guardar o fecho completo (~64 MB)
+    static const uint32_t MAX_CLOSURE = 23000;
+
+    // numero de rotulos GRAIL
+    static const int K = 3;
+
+    explicit ReachIndex(const Graph& g) {
+        tarjan(g);
+        condense(g);
+        if(m_components <= MAX_CLOSURE) {
+            closure();
+        } else {
+            grail();
+        }
+    }
+
+    // retorna true se o vertice to eh alcancavel a partir de from
+    bool reaches(uint32_t from, uint32_t to) {
+        uint32_t a = m_comp[from];
+        uint32_t b = m_comp[to];
+        if(a == b) {
+            return true;
+        }
+        if(a < b) {
+            return false;
+        }
+        if(!m_closure.empty()) {
+            return (m_closure[a * m_words + b / 64] >> (b % 64)) & 1;
+        }
+        if(!contains(a, b)) {
+            return false;
+        }
+        return prunedDfs(a, b);
+    }
+
+    // numero de componentes fortemente conexas
+    uint32_t components() const {
+        return m_components;
+    }
+
+    // componente do vertice v
+    uint32_t component(uint32_t v) const {
+        return m_comp[v];
+    }
+
+private:
+    std::vector<uint32_t> m_comp;     // componente de cada vertice
+    uint32_t m_components;            // numero de componentes
+    std::vector<uint32_t> m_offsets;  // DAG condensado em CSR
+    std::vector<uint32_t> m_targets;
+    size_t m_words;                   // palavras de 64 bits por linha do fecho
+    std::vector<uint64_t> m_closure;  // fecho transitivo (so para DAGs pequenos)
+    std::vector<uint32_t> m_low[K];   // rotulos GRAIL: [low, post]
+    std::vector<uint32_t> m_post[K];
+    std::vector<uint32_t> m_stamp;    // visitados da DFS podada (por carimbo)
+    std::vector<uint32_t> m_stack;
+    uint32_t m_epoch;
+
+    // Tarjan sem recursao: cada quadro da pilha de chamadas guarda o vertice
+    // e a posicao do proximo vizinho a examinar
+    void tarjan(const Graph& g) {
+        const uint32_t UNSEEN = UINT32_MAX;
+        uint32_t n = static_cast<uint32_t>(g.vertices());
+        std::vector<uint32_t> index(n, UNSEEN);
+        std::vector<uint32_t> low(n, 0);
+        std::vector<bool> onStack(n, false);
+        std::vector<uint32_t> stack;
+        std::vector<std::pair<uint32_t, const uint32_t*>> calls;
+        m_comp.assign(n, 0);
+        m_components = 0;
+        uint32_t counter = 0;
+
+        for(uint32_t root = 0; root < n; root++) {
+            if(index[root] != UNSEEN) {
+                continue;
+            }
+            index[root] = low[root] = counter++;
+            stack.push_back(root);
+            onStack[root] = true;
+            calls.push_back({root, g.neighbors(root).begin()});
+
+            while(!calls.empty()) {
+                uint32_t v = calls.back().first;
+                const uint32_t*& it = calls.back().second;
+                if(it != g.neighbors(v).end()) {
+                    uint32_t w = *it++;
+                    if(index[w] == UNSEEN) {
+                        index[w] = low[w] = counter++;
+                        stack.push_back(w);
+                        onStack[w] = true;
+                        calls.push_back({w, g.neighbors(w).begin()});
+                    } else if(onStack[w] && index[w] < low[v]) {
+                        low[v] = index[w];
+                    }
+                    continue;
+                }
+                // todos os vizinhos de v foram examinados
+                calls.pop_back();
+                if(!calls.empty()) {
+                    uint32_t parent = calls.back().first;
+                    if(low[v] < low[parent]) {
+                        low[parent] = low[v];
+                    }
+                }
+                if(low[v] == index[v]) {
+                    uint32_t w;
+                    do {
+                        w = stack.back();
+                        stack.pop_back();
+                        onStack[w] = false;
+                        m_comp[w] = m_components;
+                    } while(w != v);
+                    m_components++;
+                }
+            }
+        }
+    }
+
+    // monta o DAG das componentes em CSR, sem arestas repetidas nem lacos
+    void condense(const Graph& g) {
+        uint32_t n = static_cast<uint32_t>(g.vertices());
+        std::vector<uint32_t> members(n);
+        std::vector<uint32_t> start(m_components + 1, 0);
+        for(uint32_t v = 0; v < n; v++) {
+            start[m_comp[v] + 1]++;
+        }
+        for(uint32_t c = 0; c < m_components; c++) {
+            start[c + 1] += start[c];
+        }
+        std::vector<uint32_t> next(start.begin(), start.end() - 1);
+        for(uint32_t v = 0; v < n; v++) {
+            members[next[m_comp[v]]++] = v;
+        }
+
+        std::vector<uint32_t> seen(m_components, UINT32_MAX);
+        m_offsets.assign(1, 0);
+        m_targets.clear();
+        for(uint32_t c = 0; c < m_components; c++) {
+            for(uint32_t i = start[c]; i < start[c + 1]; i++) {
+                for(uint32_t w : g.neighbors(members[i])) {
+                    uint32_t d = m_comp[w];
+                    if(d != c && seen[d] != c) {
+                        seen[d] = c;
+                        m_targets.push_back(d);
+                    }
+                }
+            }
+            m_offsets.push_back(static_cast<uint32_t>(m_targets.size()));
+        }
+        m_stamp.assign(m_components, 0);
+        m_epoch = 0;
+    }
+
+    // fecho transitivo: as componentes de id menor ja estao prontas quando
+    // c eh processada (ordem topologica reversa)
+    void closure() {
+        m_words = (m_components + 63) / 64;
+        m_closure.assign(static_cast<size_t>(m_components) * m_words, 0);
+        for(uint32_t c = 0; c < m_components; c++) {
+            uint64_t* row = &m_closure[c * m_words];
+            row[c / 64] |= uint64_t(1) << (c % 64);
+            for(uint32_t i = m_offsets[c]; i < m_offsets[c + 1]; i++) {
+                const uint64_t* other = &m_closure[m_targets[i] * m_words];
+                // so as palavras ate a de d podem ter bits (ids <= d)
+                size_t used = m_targets[i] / 64 + 1;
+                for(size_t w = 0; w < used; w++) {
+                    row[w] |= other[w];
+                }
+            }
+        }
+    }
+
+    // K rotulos GRAIL; em cada um post eh a posicao em pos-ordem de uma DFS
+    // com filhos embaralhados e low eh o menor post da subarvore alcancavel
+    void grail() {
+        std::mt19937 rng(12345);
+        std::vector<uint32_t> indegree(m_components, 0);
+        for(uint32_t d : m_targets) {
+            indegree[d]++;
+        }
+        std::vector<uint32_t> roots;
+        for(uint32_t c = 0; c < m_components; c++) {
+            if(indegree[c] == 0) {
+                roots.push_back(c);
+            }
+        }
+        std::vector<uint32_t> order(m_targets);
+        std::vector<std::pair<uint32_t, uint32_t>> calls; // (componente, proximo filho)
+        for(int k = 0; k < K; k++) {
+            std::vector<uint32_t>& low = m_low[k];
+            std::vector<uint32_t>& post = m_post[k];
+            low.assign(m_components, UINT32_MAX);
+            post.assign(m_components, UINT32_MAX);
+            for(uint32_t c = 0; c < m_components; c++) {
+                std::shuffle(order.begin() + m_offsets[c], order.begin() + m_offsets[c + 1], rng);
+            }
+            std::shuffle(roots.begin(), roots.end(), rng);
+            uint32_t counter = 0;
+            for(uint32_t root : roots) {
+                calls.push_back({root, m_offsets[root]});
+                while(!calls.empty()) {
+                    uint32_t c = calls.back().first;
+                    uint32_t& i = calls.back().second;
+                    if(i < m_offsets[c + 1]) {
+                        uint32_t d = order[i++];
+                        if(post[d] == UINT32_MAX) {
+                            calls.push_back({d, m_offsets[d]});
+                        } else if(low[d] < low[c]) {
+                            low[c] = low[d];
+                        }
+                        continue;
+                    }
+                    post[c] = counter++;
+                    if(post[c] < low[c]) {
+                        low[c] = post[c];
+                    }
+                    calls.pop_back();
+                    if(!calls.empty()) {
+                        uint32_t parent = calls.back().first;
+                        if(low[c] < low[parent]) {
+                            low[parent] = low[c];
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // o intervalo de b esta contido no de a em todos os rotulos?
+    bool contains(uint32_t a, uint32_t b) const {
+        for(int k = 0; k < K; k++) {
+            if(m_low[k][b] < m_low[k][a] || m_post[k][b] > m_post[k][a]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // DFS no DAG que so desce por componentes cujo intervalo contem o de b
+    bool prunedDfs(uint32_t a, uint32_t b) {
+        if(++m_epoch == 0) {
+            std::fill(m_stamp.begin(), m_stamp.end(), 0);
+            m_epoch = 1;
+        }
+        m_stack.clear();
+        m_stack.push_back(a);
+        m_stamp[a] = m_epoch;
+        while(!m_stack.empty()) {
+            uint32_t c = m_stack.back();
+            m_stack.pop_back();
+            for(uint32_t i = m_offsets[c]; i < m_offsets[c + 1]; i++) {
+                uint32_t d = m_targets[i];
+                if(d == b) {
+                    return true;
+                }
+                if(m_stamp[d] != m_epoch && d > b && contains(d, b)) {
+                    m_stamp[d] = m_epoch;
+                    m_stack.push_back(d);
+                }
+            }
+        }
+        return false;
+    }
+};
+
+#endif
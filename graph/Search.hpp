@@ -0,0 +1,179 @@
+#ifndef SEARCH_HPP
+#define SEARCH_HPP
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+#include "Graph.hpp"
+
+// Buscas de alcancabilidade iterativas (BFS e DFS) sobre os ids do Graph.
+//
+// O conjunto de visitados eh um vetor de "carimbos": v foi visitado na busca
+// atual se m_stamp[v] == m_epoch. Cada busca so incrementa m_epoch, entao o
+// vetor nunca precisa ser limpo entre consultas; ele so eh zerado quando o
+// contador da a volta. A pilha/fila tambem eh reaproveitada, entao uma
+// consulta nao aloca memoria depois da primeira.
+//
+// bidirectional() busca em largura a partir das duas pontas ao mesmo tempo:
+// de from pelas arestas de saida e de to pelas arestas de entrada
+// (Graph::in_neighbors), expandindo a cada passo o nivel inteiro da menor
+// fronteira. Ela termina quando um lado encontra um vertice visitado pelo
+// outro. Em grafos esparsos com muitos vizinhos por vertice as duas bolas
+// de raio d/2 sao muito menores que a bola de raio d de uma busca simples.
+class Search {
+public:
+    Search() {
+        m_epoch = 0;
+        m_count = 0;
+    }
+
+    // retorna true se to eh alcancavel a partir de from (busca em largura)
+    bool bfs(const Graph& g, uint32_t from, uint32_t to) {
+        if(from == to) {
+            m_count = 0;
+            return true;
+        }
+        begin(g);
+        m_frontier.clear();
+        m_frontier.push_back(from);
+        visit(from);
+        for(size_t head = 0; head < m_frontier.size(); head++) {
+            for(uint32_t next : g.neighbors(m_frontier[head])) {
+                if(next == to) {
+                    return true;
+                }
+                if(!visited(next)) {
+                    visit(next);
+                    m_frontier.push_back(next);
+                }
+            }
+        }
+        return false;
+    }
+
+    // retorna true se to eh alcancavel a partir de from (busca em profundidade)
+    bool dfs(const Graph& g, uint32_t from, uint32_t to) {
+        if(from == to) {
+            m_count = 0;
+            return true;
+        }
+        begin(g);
+        m_frontier.clear();
+        m_frontier.push_back(from);
+        visit(from);
+        while(!m_frontier.empty()) {
+            uint32_t v = m_frontier.back();
+            m_frontier.pop_back();
+            for(uint32_t next : g.neighbors(v)) {
+                if(next == to) {
+                    return true;
+                }
+                if(!visited(next)) {
+                    visit(next);
+                    m_frontier.push_back(next);
+                }
+            }
+        }
+        return false;
+    }
+
+    // retorna true se to eh alcancavel a partir de from (busca em largura
+    // bidirecional)
+    bool bidirectional(const Graph& g, uint32_t from, uint32_t to) {
+        if(from == to) {
+            m_count = 0;
+            return true;
+        }
+        begin(g);
+        m_frontier.clear();
+        m_frontier.push_back(from);
+        visit(from);
+        m_backFrontier.clear();
+        m_backFrontier.push_back(to);
+        m_back[to] = m_epoch;
+        m_count++;
+        while(!m_frontier.empty() && !m_backFrontier.empty()) {
+            bool forward = m_frontier.size() <= m_backFrontier.size();
+            if(forward ? expandForward(g) : expandBackward(g)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // numero de vertices visitados pela ultima busca (0 se from == to)
+    size_t last_visited() const {
+        return m_count;
+    }
+
+private:
+    std::vector<uint32_t> m_stamp;    // carimbo da ultima busca que visitou cada vertice
+    std::vector<uint32_t> m_frontier; // pilha (DFS) ou fila (BFS)
+    std::vector<uint32_t> m_back;     // carimbo dos visitados a partir do destino
+    std::vector<uint32_t> m_backFrontier; // fronteira de tras (bidirecional)
+    std::vector<uint32_t> m_next;     // proximo nivel (bidirecional)
+    uint32_t m_epoch;                 // carimbo da busca atual
+    size_t m_count;                   // vertices visitados na busca atual
+
+    // inicia uma nova busca: ajusta o tamanho e troca o carimbo
+    void begin(const Graph& g) {
+        if(m_stamp.size() < g.vertices()) {
+            m_stamp.resize(g.vertices(), 0);
+            m_back.resize(g.vertices(), 0);
+        }
+        if(++m_epoch == 0) {
+            std::fill(m_stamp.begin(), m_stamp.end(), 0);
+            std::fill(m_back.begin(), m_back.end(), 0);
+            m_epoch = 1;
+        }
+        m_count = 0;
+    }
+
+    bool visited(uint32_t v) const {
+        return m_stamp[v] == m_epoch;
+    }
+
+    void visit(uint32_t v) {
+        m_stamp[v] = m_epoch;
+        m_count++;
+    }
+
+    // expande um nivel da fronteira de from; retorna true ao tocar a de to
+    bool expandForward(const Graph& g) {
+        m_next.clear();
+        for(uint32_t v : m_frontier) {
+            for(uint32_t next : g.neighbors(v)) {
+                if(m_back[next] == m_epoch) {
+                    return true;
+                }
+                if(!visited(next)) {
+                    visit(next);
+                    m_next.push_back(next);
+                }
+            }
+        }
+        m_frontier.swap(m_next);
+        return false;
+    }
+
+    // expande um nivel da fronteira de to pelas arestas de entrada
+    bool expandBackward(const Graph& g) {
+        m_next.clear();
+        for(uint32_t v : m_backFrontier) {
+            for(uint32_t prev : g.in_neighbors(v)) {
+                if(visited(prev)) {
+                    return true;
+                }
+                if(m_back[prev] != m_epoch) {
+                    m_back[prev] = m_epoch;
+                    m_count++;
+                    m_next.push_back(prev);
+                }
+            }
+        }
+        m_backFrontier.swap(m_next);
+        return false;
+    }
+};
+
+#endif
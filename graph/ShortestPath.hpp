@@ -0,0 +1,445 @@
+#ifndef SHORTESTPATH_HPP
+#define SHORTESTPATH_HPP
+#include <cstdint>
+#include <vector>
+#include <map>
+#include <atomic>
+#include <thread>
+#include <functional>
+#include <utility>
+#include <algorithm>
+
+#include "Graph.hpp"
+#include "Barrier.hpp"
+#include "../PQueue/IndexedPq.hpp"
+
+// Caminhos minimos a partir de uma origem em grafos com pesos inteiros nao
+// negativos (grafos sem pesos usam peso 1 em todas as arestas).
+//
+// Dijkstra usa a fila enderecavel IndexedPq: cada vertice entra uma unica vez
+// na fila e seu handle permite diminuir a distancia no lugar (decrease_key),
+// em vez de inserir copias e descartar as velhas. Pq nao serve aqui: seu
+// increaseKey/decreaseKey recebe a posicao no heap, que o chamador nao tem
+// como acompanhar depois dos sifts; IndexedPq eh o heap binario de Pq (mesmo
+// Comparator, mesmos fixUp/fixDown com "buraco") com o mapa de posicoes.
+// Como em Search, as distancias sao validas so para os vertices com o
+// carimbo da busca atual, entao uma consulta nao precisa limpar vetores de
+// tamanho n. A busca para assim que todos os destinos pedidos saem da fila.
+//
+// DeltaStepping (Meyer e Sanders) eh a variante paralela para grafos
+// grandes. Os vertices ficam em baldes de largura delta pela distancia; o
+// menor balde nao vazio eh processado em fases, relaxando em paralelo as
+// arestas leves (peso <= delta), que podem devolver vertices ao mesmo balde.
+// Quando o balde esvazia, as arestas pesadas dos vertices que passaram por
+// ele sao relaxadas uma unica vez. As distancias sao atomicas e diminuidas
+// com compare_exchange; cada thread junta os vertices melhorados em um buffer
+// local, redistribuido nos baldes por uma unica thread entre duas barreiras.
+class Dijkstra {
+public:
+    // distancia de um vertice nao alcancado
+    static constexpr uint64_t INFINITE = UINT64_MAX;
+
+    explicit Dijkstra(const Graph& g) : m_graph(g) {
+        size_t n = g.vertices();
+        m_dist.resize(n);
+        m_handle.resize(n);
+        m_stamp.assign(n, 0);
+        m_wanted.assign(n, 0);
+        m_epoch = 0;
+        m_settled = 0;
+    }
+
+    // distancia de from a to, ou INFINITE
+    uint64_t distance(uint32_t from, uint32_t to) {
+        run(from, &to, 1);
+        return dist(to);
+    }
+
+    // distancias de source a cada vertice de targets (na mesma ordem), com
+    // uma unica busca
+    std::vector<uint64_t> one_to_many(uint32_t source, const std::vector<uint32_t>& targets) {
+        std::vector<uint64_t> result;
+        result.reserve(targets.size());
+        if(!targets.empty()) {
+            run(source, targets.data(), targets.size());
+        }
+        for(uint32_t t : targets) {
+            result.push_back(dist(t));
+        }
+        return result;
+    }
+
+    // distancias de source a todos os vertices
+    std::vector<uint64_t> distances(uint32_t source) {
+        run(source, nullptr, 0);
+        std::vector<uint64_t> result(m_dist.size());
+        for(uint32_t v = 0; v < result.size(); v++) {
+            result[v] = dist(v);
+        }
+        return result;
+    }
+
+    // vertices fixados (retirados da fila) na ultima busca
+    size_t settled() const {
+        return m_settled;
+    }
+
+private:
+    // (distancia, vertice); std::greater faz da fila um heap de minimo
+    using Entry = std::pair<uint64_t, uint32_t>;
+    using Queue = IndexedPq<Entry, std::greater<Entry>>;
+
+    // handle de um vertice que ja saiu da fila (nunca eh um handle valido)
+    static constexpr Queue::Handle SETTLED = UINT64_MAX;
+
+    const Graph& m_graph;
+    Queue m_queue;
+    std::vector<uint64_t> m_dist;       // distancia provisoria
+    std::vector<Queue::Handle> m_handle; // handle na fila ou SETTLED
+    std::vector<uint32_t> m_stamp;      // m_dist/m_handle validos na busca atual
+    std::vector<uint32_t> m_wanted;     // destino da busca atual
+    uint32_t m_epoch;
+    size_t m_settled;
+
+    uint64_t dist(uint32_t v) const {
+        return v < m_stamp.size() && m_stamp[v] == m_epoch ? m_dist[v] : INFINITE;
+    }
+
+    // inicia uma busca nova
+    void begin() {
+        if(++m_epoch == 0) {
+            std::fill(m_stamp.begin(), m_stamp.end(), 0);
+            std::fill(m_wanted.begin(), m_wanted.end(), 0);
+            m_epoch = 1;
+        }
+        m_queue.clear();
+        m_settled = 0;
+    }
+
+    // Dijkstra a partir de source; com count > 0 para quando os count
+    // vertices de targets tiverem sido fixados
+    void run(uint32_t source, const uint32_t* targets, size_t count) {
+        begin();
+        if(source >= m_dist.size()) {
+            return;
+        }
+        size_t pending = 0;
+        for(size_t i = 0; i < count; i++) {
+            uint32_t t = targets[i];
+            if(t < m_wanted.size() && m_wanted[t] != m_epoch) {
+                m_wanted[t] = m_epoch;
+                pending++;
+            }
+        }
+        if(count > 0 && pending == 0) {
+            return;
+        }
+
+        m_stamp[source] = m_epoch;
+        m_dist[source] = 0;
+        m_handle[source] = m_queue.push(Entry(0, source));
+        while(!m_queue.empty()) {
+            Entry top = m_queue.pop();
+            uint32_t u = top.second;
+            m_handle[u] = SETTLED;
+            m_settled++;
+            if(count > 0 && m_wanted[u] == m_epoch && --pending == 0) {
+                break;
+            }
+            Graph::Range next = m_graph.neighbors(u);
+            const uint32_t* weights = m_graph.weights(u);
+            for(size_t k = 0; k < next.size(); k++) {
+                uint32_t v = next.first[k];
+                uint64_t d = top.first + (weights != nullptr ? weights[k] : 1);
+                if(m_stamp[v] != m_epoch) {
+                    m_stamp[v] = m_epoch;
+                    m_dist[v] = d;
+                    m_handle[v] = m_queue.push(Entry(d, v));
+                } else if(d < m_dist[v] && m_handle[v] != SETTLED) {
+                    m_dist[v] = d;
+                    m_queue.decrease_key(m_handle[v], Entry(d, v));
+                }
+            }
+        }
+    }
+};
+
+// distancias de cada origem de sources a cada destino de targets:
+// result[i][j] eh a distancia de sources[i] a targets[j]. As origens sao
+// distribuidas entre threads threads (0 usa hardware_concurrency), cada uma
+// com o seu Dijkstra.
+inline std::vector<std::vector<uint64_t>> many_to_many(const Graph& g, const std::vector<uint32_t>& sources,
+                                                       const std::vector<uint32_t>& targets, unsigned threads = 0) {
+    std::vector<std::vector<uint64_t>> result(sources.size());
+    if(threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+    if(threads == 0 || threads > sources.size()) {
+        threads = sources.empty() ? 1 : static_cast<unsigned>(sources.size());
+    }
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        Dijkstra dijkstra(g);
+        size_t i;
+        while((i = next.fetch_add(1, std::memory_order_relaxed)) < sources.size()) {
+            result[i] = dijkstra.one_to_many(sources[i], targets);
+        }
+    };
+    std::vector<std::thread> pool;
+    for(unsigned t = 1; t < threads; t++) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for(std::thread& t : pool) {
+        t.join();
+    }
+    return result;
+}
+
+class DeltaStepping {
+public:
+    // distancia de um vertice nao alcancado
+    static constexpr uint64_t INFINITE = UINT64_MAX;
+
+    // delta = 0 escolhe maior peso / grau medio (no minimo 1);
+    // threads = 0 usa std::thread::hardware_concurrency()
+    explicit DeltaStepping(const Graph& g, uint64_t delta = 0, unsigned threads = 0) : m_graph(g) {
+        m_threads = threads != 0 ? threads : std::thread::hardware_concurrency();
+        if(m_threads == 0) {
+            m_threads = 1;
+        }
+        m_n = static_cast<uint32_t>(g.vertices());
+        m_delta = delta != 0 ? delta : defaultDelta();
+        m_dist = std::vector<std::atomic<uint64_t>>(m_n);
+        m_seen.assign(m_n, 0);
+        m_inBucket.assign(m_n, 0);
+        m_epoch = 0;
+        m_local.resize(m_threads);
+    }
+
+    // distancias de source a todos os vertices
+    std::vector<uint64_t> distances(uint32_t source) {
+        run(source);
+        std::vector<uint64_t> result(m_n);
+        for(uint32_t v = 0; v < m_n; v++) {
+            result[v] = m_dist[v].load(std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+    // distancia de from a to, ou INFINITE
+    uint64_t distance(uint32_t from, uint32_t to) {
+        if(from >= m_n || to >= m_n) {
+            return from == to ? 0 : INFINITE;
+        }
+        run(from);
+        return m_dist[to].load(std::memory_order_relaxed);
+    }
+
+    // largura dos baldes
+    uint64_t delta() const {
+        return m_delta;
+    }
+
+    // fases (leves e pesadas) executadas na ultima busca
+    unsigned phases() const {
+        return m_phases;
+    }
+
+private:
+    // tamanho dos blocos da fronteira distribuidos entre as threads
+    static constexpr uint32_t CHUNK = 64;
+
+    const Graph& m_graph;
+    unsigned m_threads;
+    uint32_t m_n;
+    uint64_t m_delta;
+
+    std::vector<std::atomic<uint64_t>> m_dist;
+    std::map<uint64_t, std::vector<uint32_t>> m_buckets; // indice -> vertices (pode ter repetidos)
+    uint64_t m_bucket;                  // balde atual
+    std::vector<uint32_t> m_frontier;   // vertices da fase atual
+    std::vector<uint32_t> m_settledSet; // vertices que passaram pelo balde atual
+    std::vector<uint32_t> m_seen;       // carimbo: ja esta na fronteira da fase
+    std::vector<uint32_t> m_inBucket;   // carimbo: ja esta em m_settledSet
+    uint32_t m_epoch;
+    uint32_t m_bucketEpoch;             // carimbo de m_inBucket do balde atual
+    std::vector<std::vector<uint32_t>> m_local; // vertices melhorados por thread
+    std::atomic<uint32_t> m_cursor;
+    bool m_heavy;                       // a fase atual relaxa arestas pesadas
+    bool m_done;
+    unsigned m_phases;
+
+    Barrier m_barrier;                  // separa as fases das threads
+
+    uint64_t defaultDelta() const {
+        uint64_t heaviest = 1;
+        for(uint32_t v = 0; v < m_n; v++) {
+            const uint32_t* weights = m_graph.weights(v);
+            if(weights == nullptr) {
+                continue;
+            }
+            for(size_t k = 0; k < m_graph.neighbors(v).size(); k++) {
+                heaviest = std::max<uint64_t>(heaviest, weights[k]);
+            }
+        }
+        uint64_t degree = m_n == 0 ? 1 : std::max<uint64_t>(1, m_graph.edges() / m_n);
+        return std::max<uint64_t>(1, heaviest / degree);
+    }
+
+    uint32_t stamp() {
+        if(++m_epoch == 0) {
+            std::fill(m_seen.begin(), m_seen.end(), 0);
+            std::fill(m_inBucket.begin(), m_inBucket.end(), 0);
+            m_epoch = 1;
+        }
+        return m_epoch;
+    }
+
+    // diminui a distancia de v para d; retorna true se d era menor
+    bool relax(uint32_t v, uint64_t d) {
+        uint64_t old = m_dist[v].load(std::memory_order_relaxed);
+        while(d < old) {
+            if(m_dist[v].compare_exchange_weak(old, d, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // relaxa as arestas leves (ou pesadas) de blocos da fronteira
+    void expand(std::vector<uint32_t>& local) {
+        uint32_t size = static_cast<uint32_t>(m_frontier.size());
+        while(true) {
+            uint32_t begin = m_cursor.fetch_add(CHUNK, std::memory_order_relaxed);
+            if(begin >= size) {
+                break;
+            }
+            uint32_t end = begin + CHUNK < size ? begin + CHUNK : size;
+            for(uint32_t i = begin; i < end; i++) {
+                uint32_t u = m_frontier[i];
+                uint64_t du = m_dist[u].load(std::memory_order_relaxed);
+                Graph::Range next = m_graph.neighbors(u);
+                const uint32_t* weights = m_graph.weights(u);
+                for(size_t k = 0; k < next.size(); k++) {
+                    uint64_t w = weights != nullptr ? weights[k] : 1;
+                    if((w > m_delta) == m_heavy && relax(next.first[k], du + w)) {
+                        local.push_back(next.first[k]);
+                    }
+                }
+            }
+        }
+    }
+
+    // distribui os vertices melhorados nos baldes e prepara a proxima fase
+    // (executado por uma unica thread entre duas barreiras)
+    void advance() {
+        for(std::vector<uint32_t>& local : m_local) {
+            for(uint32_t v : local) {
+                m_buckets[m_dist[v].load(std::memory_order_relaxed) / m_delta].push_back(v);
+            }
+            local.clear();
+        }
+        m_cursor.store(0, std::memory_order_relaxed);
+        m_frontier.clear();
+        while(true) {
+            if(!m_heavy) {
+                auto it = m_buckets.find(m_bucket);
+                if(it != m_buckets.end()) {
+                    // fase leve: vertices que (ainda) pertencem ao balde,
+                    // sem repeticoes
+                    std::vector<uint32_t> items;
+                    items.swap(it->second);
+                    m_buckets.erase(it);
+                    uint32_t epoch = stamp();
+                    for(uint32_t v : items) {
+                        if(m_seen[v] != epoch && m_dist[v].load(std::memory_order_relaxed) / m_delta == m_bucket) {
+                            m_seen[v] = epoch;
+                            m_frontier.push_back(v);
+                        }
+                    }
+                    if(!m_frontier.empty()) {
+                        m_phases++;
+                        return;
+                    }
+                    continue;
+                }
+                // balde vazio: fase pesada com os vertices que passaram por ele
+                m_heavy = true;
+                m_frontier.swap(m_settledSet);
+                m_settledSet.clear();
+                if(!m_frontier.empty()) {
+                    m_phases++;
+                    return;
+                }
+            }
+            m_heavy = false;
+            if(m_buckets.empty()) {
+                m_done = true;
+                return;
+            }
+            m_bucket = m_buckets.begin()->first;
+            m_bucketEpoch = stamp();
+        }
+    }
+
+    // guarda os vertices da fase leve para a fase pesada do balde
+    void remember() {
+        if(m_heavy) {
+            return;
+        }
+        for(uint32_t v : m_frontier) {
+            if(m_inBucket[v] != m_bucketEpoch) {
+                m_inBucket[v] = m_bucketEpoch;
+                m_settledSet.push_back(v);
+            }
+        }
+    }
+
+    // corpo de cada thread: executa fases ate a busca terminar
+    void worker(unsigned id) {
+        while(true) {
+            expand(m_local[id]);
+            m_barrier.wait();
+            if(id == 0) {
+                remember();
+                advance();
+            }
+            m_barrier.wait();
+            if(m_done) {
+                break;
+            }
+        }
+    }
+
+    void run(uint32_t source) {
+        for(uint32_t v = 0; v < m_n; v++) {
+            m_dist[v].store(INFINITE, std::memory_order_relaxed);
+        }
+        m_buckets.clear();
+        m_settledSet.clear();
+        m_phases = 0;
+        m_done = false;
+        m_heavy = false;
+        m_barrier.reset(m_threads);
+        if(source >= m_n) {
+            return;
+        }
+        m_dist[source].store(0, std::memory_order_relaxed);
+        m_buckets[0].push_back(source);
+        m_bucket = 0;
+        m_bucketEpoch = stamp();
+        advance();
+
+        std::vector<std::thread> pool;
+        for(unsigned id = 1; id < m_threads; id++) {
+            pool.emplace_back(&DeltaStepping::worker, this, id);
+        }
+        worker(0);
+        for(std::thread& t : pool) {
+            t.join();
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,222 @@
+#ifndef UNIONFIND_HPP
+#define UNIONFIND_HPP
+#include <cstdint>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+
+#include "Graph.hpp"
+#include "Parallel.hpp"
+
+// Conjuntos disjuntos sobre os ids do Graph, para perguntas de
+// conectividade sem direcao (a e b estao ligados por algum caminho,
+// ignorando o sentido das arestas?).
+//
+// UnionFind eh a versao sequencial: uniao por posto e compressao de
+// caminho, entao uma sequencia de m operacoes custa O(m alpha(n)). Ela
+// aceita vertices novos com add(), entao pode acompanhar um grafo que
+// cresce aresta a aresta.
+//
+// ConcurrentUnionFind pode ser usada por varias threads ao mesmo tempo sem
+// locks. Os pais sao atomicos; find() faz divisao de caminho (cada vertice
+// passa a apontar para o avo) com compare_exchange, e unite() liga a raiz
+// de id maior a de id menor com um compare_exchange que so tem sucesso se
+// ela ainda for raiz, tentando de novo caso contrario. Ligar sempre pelo id
+// mantem as arvores aciclicas sem precisar de posto.
+class UnionFind {
+public:
+    explicit UnionFind(uint32_t n = 0) {
+        m_parent.resize(n);
+        for(uint32_t v = 0; v < n; v++) {
+            m_parent[v] = v;
+        }
+        m_rank.assign(n, 0);
+        m_sets = n;
+    }
+
+    // um conjunto para cada vertice de g, unidos pelas arestas de g
+    explicit UnionFind(const Graph& g) : UnionFind(static_cast<uint32_t>(g.vertices())) {
+        for(uint32_t v = 0; v < g.vertices(); v++) {
+            for(uint32_t w : g.neighbors(v)) {
+                unite(v, w);
+            }
+        }
+    }
+
+    // cria um conjunto unitario e retorna seu id
+    uint32_t add() {
+        uint32_t v = static_cast<uint32_t>(m_parent.size());
+        m_parent.push_back(v);
+        m_rank.push_back(0);
+        m_sets++;
+        return v;
+    }
+
+    // representante do conjunto de v; comprime o caminho percorrido
+    uint32_t find(uint32_t v) {
+        uint32_t root = v;
+        while(m_parent[root] != root) {
+            root = m_parent[root];
+        }
+        while(m_parent[v] != root) {
+            uint32_t next = m_parent[v];
+            m_parent[v] = root;
+            v = next;
+        }
+        return root;
+    }
+
+    // une os conjuntos de a e b; retorna false se ja eram o mesmo
+    bool unite(uint32_t a, uint32_t b) {
+        a = find(a);
+        b = find(b);
+        if(a == b) {
+            return false;
+        }
+        if(m_rank[a] < m_rank[b]) {
+            std::swap(a, b);
+        }
+        m_parent[b] = a;
+        if(m_rank[a] == m_rank[b]) {
+            m_rank[a]++;
+        }
+        m_sets--;
+        return true;
+    }
+
+    // retorna true se a e b estao no mesmo conjunto
+    bool connected(uint32_t a, uint32_t b) {
+        return find(a) == find(b);
+    }
+
+    // numero de elementos
+    size_t size() const {
+        return m_parent.size();
+    }
+
+    // numero de conjuntos
+    size_t sets() const {
+        return m_sets;
+    }
+
+private:
+    std::vector<uint32_t> m_parent;
+    std::vector<uint8_t> m_rank;    // limite superior da altura (no maximo log n)
+    size_t m_sets;
+};
+
+class ConcurrentUnionFind {
+public:
+    explicit ConcurrentUnionFind(uint32_t n) : m_parent(n) {
+        for(uint32_t v = 0; v < n; v++) {
+            m_parent[v].store(v, std::memory_order_relaxed);
+        }
+    }
+
+    // representante do conjunto de v (pode mudar se outra thread unir)
+    uint32_t find(uint32_t v) {
+        while(true) {
+            uint32_t parent = m_parent[v].load(std::memory_order_relaxed);
+            if(parent == v) {
+                return v;
+            }
+            uint32_t grand = m_parent[parent].load(std::memory_order_relaxed);
+            if(grand != parent) {
+                // divisao de caminho; se falhar outra thread ja encurtou
+                m_parent[v].compare_exchange_weak(parent, grand, std::memory_order_relaxed);
+            }
+            v = grand;
+        }
+    }
+
+    // une os conjuntos de a e b; retorna false se ja eram o mesmo
+    bool unite(uint32_t a, uint32_t b) {
+        while(true) {
+            a = find(a);
+            b = find(b);
+            if(a == b) {
+                return false;
+            }
+            if(a < b) {
+                std::swap(a, b);
+            }
+            // a (maior) passa a apontar para b, se a ainda for raiz
+            uint32_t expected = a;
+            if(m_parent[a].compare_exchange_strong(expected, b, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+    }
+
+    // retorna true se a e b estao no mesmo conjunto; so eh exato quando
+    // nenhuma outra thread esta unindo conjuntos
+    bool connected(uint32_t a, uint32_t b) {
+        while(true) {
+            a = find(a);
+            b = find(b);
+            if(a == b) {
+                return true;
+            }
+            // se a continua raiz, a e b estavam separados nesse instante
+            if(m_parent[a].load(std::memory_order_relaxed) == a) {
+                return false;
+            }
+        }
+    }
+
+    // numero de elementos
+    size_t size() const {
+        return m_parent.size();
+    }
+
+private:
+    std::vector<std::atomic<uint32_t>> m_parent;
+};
+
+// Rotula as componentes conexas de g (ignorando o sentido das arestas):
+// label[v] eh o menor id da componente de v. As arestas sao divididas entre
+// threads threads (0 usa hardware_concurrency) que unem os conjuntos de uma
+// ConcurrentUnionFind; depois os rotulos sao lidos em paralelo. Como a
+// raiz de cada conjunto eh sempre o seu menor id, o resultado nao depende
+// da ordem das unioes.
+inline std::vector<uint32_t> connected_components(const Graph& g, unsigned threads = 0) {
+    uint32_t n = static_cast<uint32_t>(g.vertices());
+    if(threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+    if(threads == 0) {
+        threads = 1;
+    }
+    if(g.edges() / threads < 4096) {
+        threads = static_cast<unsigned>(g.edges() / 4096 + 1);
+    }
+    ConcurrentUnionFind sets(n);
+    std::vector<uint32_t> label(n);
+
+    // blocos de vertices com numero parecido de arestas
+    std::vector<uint32_t> bound(threads + 1, n);
+    bound[0] = 0;
+    size_t seen = 0;
+    for(uint32_t v = 0, t = 1; v < n && t < threads; v++) {
+        seen += g.neighbors(v).size();
+        while(t < threads && seen >= g.edges() * t / threads) {
+            bound[t++] = v + 1;
+        }
+    }
+    parallel(threads, [&](unsigned t) {
+        for(uint32_t v = bound[t]; v < bound[t + 1]; v++) {
+            for(uint32_t w : g.neighbors(v)) {
+                sets.unite(v, w);
+            }
+        }
+    });
+    parallel(threads, [&](unsigned t) {
+        for(uint32_t v = n * uint64_t(t) / threads; v < n * uint64_t(t + 1) / threads; v++) {
+            label[v] = sets.find(v);
+        }
+    });
+    return label;
+}
+
+#endif
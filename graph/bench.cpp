@@ -0,0 +1,72 @@
+// Compara a busca simples (DFS e BFS) com a BFS bidirecional em consultas
+// ponto a ponto sobre um grafo aleatorio esparso: cada vertice tem grau de
+// saida fixo e destinos uniformes. Imprime a media de vertices visitados
+// por consulta e o tempo total de cada busca.
+//
+//   g++ -std=c++17 -O2 -pthread bench.cpp -o bench
+//   ./bench [vertices] [grau] [consultas]
+#include "Graph.hpp"
+#include "Search.hpp"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+using namespace std;
+
+// resultado de uma bateria de consultas
+struct Result {
+    double visited;   // media de vertices visitados
+    double seconds;   // tempo total
+    size_t reached;   // consultas com resposta true
+};
+
+template <typename Fn>
+Result run(Search& s, const vector<pair<uint32_t, uint32_t>>& queries, Fn query) {
+    Result r = {0, 0, 0};
+    size_t total = 0;
+    auto start = chrono::steady_clock::now();
+    for(const auto& q : queries) {
+        r.reached += query(q.first, q.second) ? 1 : 0;
+        total += s.last_visited();
+    }
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    r.seconds = elapsed.count();
+    r.visited = queries.empty() ? 0 : double(total) / queries.size();
+    return r;
+}
+
+int main(int argc, char* argv[]) {
+    uint32_t n = argc > 1 ? stoul(argv[1]) : 1000000;
+    uint32_t degree = argc > 2 ? stoul(argv[2]) : 16;
+    size_t count = argc > 3 ? stoul(argv[3]) : 200;
+
+    Graph g;
+    for(uint32_t v = 0; v < n; v++) {
+        g.add_vertex(to_string(v));
+    }
+    mt19937 rng(42);
+    uniform_int_distribution<uint32_t> pick(0, n - 1);
+    for(uint32_t v = 0; v < n; v++) {
+        for(uint32_t k = 0; k < degree; k++) {
+            g.add_edge(v, pick(rng));
+        }
+    }
+    g.build();
+
+    vector<pair<uint32_t, uint32_t>> queries;
+    for(size_t i = 0; i < count; i++) {
+        queries.push_back({pick(rng), pick(rng)});
+    }
+
+    Search s;
+    Result dfs = run(s, queries, [&](uint32_t a, uint32_t b) { return s.dfs(g, a, b); });
+    Result bfs = run(s, queries, [&](uint32_t a, uint32_t b) { return s.bfs(g, a, b); });
+    Result bi = run(s, queries, [&](uint32_t a, uint32_t b) { return s.bidirectional(g, a, b); });
+
+    cout << n << " vertices, " << g.edges() << " arestas, " << count << " consultas" << endl;
+    cout << "busca\tvisitados/consulta\ttempo (s)\ttrue" << endl;
+    cout << "dfs\t" << dfs.visited << "\t" << dfs.seconds << "\t" << dfs.reached << endl;
+    cout << "bfs\t" << bfs.visited << "\t" << bfs.seconds << "\t" << bfs.reached << endl;
+    cout << "bidir\t" << bi.visited << "\t" << bi.seconds << "\t" << bi.reached << endl;
+}
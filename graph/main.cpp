@@ -1,64 +1,254 @@
+// Alcancabilidade em um grafo dirigido.
+//
+// Compilar:  g++ -std=c++17 -O2 -pthread main.cpp -o graph
+// Executar:  ./graph [opcoes] < entrada
+//
+// Entrada: numero de vertices e seus nomes, numero de relacoes e os pares
+// "origem destino", numero de consultas e os pares "a b". Para cada consulta
+// imprime "true a b" se b eh alcancavel a partir de a, senao "false a b".
+// Sem opcoes cada consulta eh uma BFS bidirecional (Search.hpp).
+//
+//   --index   pre-processa o grafo (componentes fortemente conexas + fecho
+//             transitivo ou rotulos GRAIL, ver ReachIndex.hpp) e responde
+//             as consultas pelo indice; vale a pena com muitas consultas
+//   --threads N  responde cada consulta com a BFS paralela de N threads
+//             (ParallelBfs.hpp); vale a pena com grafos muito grandes
+//   --load-threads N  le a secao de arestas com N threads (Loader.hpp)
+//   --binary arq      le vertices e arestas do grafo binario arq; a entrada
+//             padrao passa a conter so as consultas
+//   --save-binary arq grava o grafo lido no formato binario em arq
+//   --weighted  cada relacao eh "origem destino peso" e cada consulta imprime
+//             "distancia a b" (ou "inf a b") com o caminho minimo de a ate b;
+//             as consultas de uma mesma origem sao respondidas por um unico
+//             Dijkstra (ShortestPath.hpp). Com --threads N usa Delta-stepping
+//             paralelo; --delta D fixa a largura dos baldes
+//   --dynamic  a ultima secao eh uma sequencia de comandos "put a b" (insere
+//             a aresta a -> b, se a foi declarado) e "has a b" (consulta);
+//             usa o DynamicGraph, cujo cache de alcancabilidade eh
+//             atualizado a cada insercao. --cache N fixa quantas origens
+//             ficam no cache (0 desliga)
+//   --connectivity  as consultas perguntam se a e b estao na mesma componente
+//             conexa, ignorando o sentido das arestas (UnionFind.hpp). O
+//             grafo lido eh rotulado de uma vez (com --threads N, em
+//             paralelo); com --dynamic um union-find eh atualizado a cada put
 #include <iostream>
-#include <unordered_set>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <memory>
+#include <algorithm>
+
+#include "Graph.hpp"
+#include "Search.hpp"
+#include "ReachIndex.hpp"
+#include "ParallelBfs.hpp"
+#include "Loader.hpp"
+#include "ShortestPath.hpp"
+#include "DynamicGraph.hpp"
+#include "UnionFind.hpp"
 
 using namespace std;
 
-vector<vector<string>> graph;
+Graph graph;
+
+Search busca;
+unique_ptr<ReachIndex> indice; // so existe com --index
+unique_ptr<ParallelBfs> paralela; // so existe com --threads
 
-void put(string find, string put){
-    for(int i = 0; i < graph.size(); i++){
-        if(graph[i][0] == find){
-            graph[i].push_back(put);
+bool has_relacion(string_view a, string_view b) {
+    if (a == b) return true;
+    uint32_t from = graph.id(a);
+    uint32_t to = graph.id(b);
+    if (from == Graph::NONE || to == Graph::NONE) return false;
+    if (indice) return indice->reaches(from, to);
+    if (paralela) return paralela->reaches(from, to);
+    return busca.bidirectional(graph, from, to);
+}
+
+// responde as consultas com distancias, agrupando-as pela origem
+void responder_distancias(const vector<loader::Query>& consultas, unsigned threads, uint64_t delta) {
+    vector<uint32_t> origem(consultas.size()), destino(consultas.size());
+    vector<size_t> ordem;
+    vector<uint64_t> resposta(consultas.size(), Dijkstra::INFINITE);
+    for(size_t i = 0; i < consultas.size(); i++){
+        origem[i] = graph.id(consultas[i].a);
+        destino[i] = graph.id(consultas[i].b);
+        if(consultas[i].a == consultas[i].b){
+            resposta[i] = 0;
+        }else if(origem[i] != Graph::NONE && destino[i] != Graph::NONE){
+            ordem.push_back(i);
         }
     }
-}
+    stable_sort(ordem.begin(), ordem.end(), [&](size_t x, size_t y){ return origem[x] < origem[y]; });
 
-bool dfs_find(const string &current, const string &target, unordered_set<string> &visited) {
-    if (current == target) return true;
-    visited.insert(current); 
+    Dijkstra dijkstra(graph);
+    unique_ptr<DeltaStepping> delta_stepping;
+    if(threads > 0){
+        delta_stepping.reset(new DeltaStepping(graph, delta, threads));
+    }
+    vector<uint32_t> alvos;
+    for(size_t inicio = 0, fim; inicio < ordem.size(); inicio = fim){
+        uint32_t from = origem[ordem[inicio]];
+        alvos.clear();
+        for(fim = inicio; fim < ordem.size() && origem[ordem[fim]] == from; fim++){
+            alvos.push_back(destino[ordem[fim]]);
+        }
+        vector<uint64_t> dist;
+        if(delta_stepping){
+            vector<uint64_t> todas = delta_stepping->distances(from);
+            for(uint32_t to : alvos){
+                dist.push_back(todas[to]);
+            }
+        }else{
+            dist = dijkstra.one_to_many(from, alvos);
+        }
+        for(size_t k = inicio; k < fim; k++){
+            resposta[ordem[k]] = dist[k - inicio];
+        }
+    }
+
+    for(size_t i = 0; i < consultas.size(); i++){
+        if(resposta[i] == Dijkstra::INFINITE){
+            cout << "inf";
+        }else{
+            cout << resposta[i];
+        }
+        cout << " " << consultas[i].a << " " << consultas[i].b << '\n';
+    }
+}
 
-    for (auto &node : graph) {
-        if (!node.empty() && node[0] == current) {
-            for (size_t j = 1; j < node.size(); j++) {
-                const string &next = node[j];
-                if (visited.find(next) == visited.end() && dfs_find(next, target, visited)) {
-                    return true;
+// executa os comandos put/has sobre um DynamicGraph montado a partir de
+// graph; com conectividade os has sao respondidos por um union-find
+// atualizado a cada put
+void executar_comandos(const vector<loader::Command>& comandos, size_t cache, bool conectividade) {
+    DynamicGraph dinamico(graph, conectividade ? 0 : cache);
+    UnionFind conjuntos;
+    if(conectividade){
+        conjuntos = UnionFind(graph);
+    }
+    for(const loader::Command& c : comandos){
+        if(c.put){
+            uint32_t from = dinamico.id(c.a);
+            if(from != DynamicGraph::NONE && dinamico.declared(from)){
+                uint32_t to = dinamico.intern(c.b);
+                if(conectividade){
+                    while(conjuntos.size() < dinamico.vertices()){
+                        conjuntos.add();
+                    }
+                    conjuntos.unite(from, to);
                 }
+                dinamico.add_edge(from, to);
+            }
+            continue;
+        }
+        bool resposta = c.a == c.b;
+        if(!resposta){
+            uint32_t from = dinamico.id(c.a);
+            uint32_t to = dinamico.id(c.b);
+            if(from != DynamicGraph::NONE && to != DynamicGraph::NONE){
+                resposta = conectividade ? conjuntos.connected(from, to) : dinamico.reaches(from, to);
             }
         }
+        cout << (resposta ? "true" : "false") << " " << c.a << " " << c.b << '\n';
     }
-    return false;
 }
 
-bool has_relacion(string a, string b) {
-    unordered_set<string> visited; 
-    return dfs_find(a, b, visited);
-}
+int main(int argc, char* argv[]){
+    ios::sync_with_stdio(false);
+    bool usar_indice = false;
+    bool com_pesos = false;
+    bool dinamico = false;
+    bool conectividade = false;
+    size_t cache = 64;
+    uint64_t delta = 0;
+    unsigned threads = 0;
+    unsigned threads_leitura = 1;
+    string binario, salvar_binario;
+    for(int i = 1; i < argc; i++){
+        if(string(argv[i]) == "--index"){
+            usar_indice = true;
+        }else if(string(argv[i]) == "--threads" && i + 1 < argc){
+            threads = stoul(argv[++i]);
+            if(threads == 0){
+                threads = thread::hardware_concurrency();
+            }
+        }else if(string(argv[i]) == "--load-threads" && i + 1 < argc){
+            threads_leitura = stoul(argv[++i]);
+            if(threads_leitura == 0){
+                threads_leitura = thread::hardware_concurrency();
+            }
+        }else if(string(argv[i]) == "--binary" && i + 1 < argc){
+            binario = argv[++i];
+        }else if(string(argv[i]) == "--save-binary" && i + 1 < argc){
+            salvar_binario = argv[++i];
+        }else if(string(argv[i]) == "--dynamic"){
+            dinamico = true;
+        }else if(string(argv[i]) == "--cache" && i + 1 < argc){
+            cache = stoul(argv[++i]);
+        }else if(string(argv[i]) == "--connectivity"){
+            conectividade = true;
+        }else if(string(argv[i]) == "--weighted"){
+            com_pesos = true;
+        }else if(string(argv[i]) == "--delta" && i + 1 < argc){
+            delta = stoull(argv[++i]);
+        }else{
+            cerr << "Opção desconhecida: " << argv[i] << endl;
+            return 1;
+        }
+    }
 
-int main(){
-    int quant_vertices, quant_relacoes, quant_finds;
-    cin >> quant_vertices;
-    graph.resize(quant_vertices);
-    
-    for(int i = 0; i < quant_vertices; i++){
-        string aux;
-        cin >> aux;
-        graph[i].push_back(aux);
+    // as consultas apontam para dentro de entrada, que vive ate o fim
+    loader::Input entrada("-");
+    vector<loader::Query> consultas;
+    vector<loader::Command> comandos;
+    try{
+        loader::Scanner scanner(entrada.data(), entrada.data() + entrada.size());
+        if(binario.empty()){
+            loader::read_graph(scanner, graph, threads_leitura, com_pesos);
+        }else{
+            loader::read_binary(binario, graph, threads_leitura);
+        }
+        if(dinamico){
+            loader::read_commands(scanner, comandos);
+        }else{
+            loader::read_queries(scanner, consultas);
+        }
+        if(!salvar_binario.empty()){
+            loader::write_binary(salvar_binario, graph);
+        }
+    }catch(const exception& e){
+        cerr << e.what() << endl;
+        return 1;
     }
 
-    cin >> quant_relacoes;
-    for(int i = 0; i < quant_relacoes; i++){
-        string first, second;
-        cin >> first >> second;
-        put(first, second);
+    if(dinamico){
+        executar_comandos(comandos, cache, conectividade);
+        return 0;
     }
 
-    cin >> quant_finds;
-    for(int i = 0; i < quant_finds; i++){
-        string first, second;
-        cin >> first >> second;
-        cout << (has_relacion(first,second) ? "true" : "false") << " " << first << " " << second << endl;
+    if(com_pesos){
+        responder_distancias(consultas, threads, delta);
+        return 0;
     }
-}
\ No newline at end of file
+
+    if(conectividade){
+        vector<uint32_t> componente = connected_components(graph, threads > 0 ? threads : 1);
+        for(const loader::Query& q : consultas){
+            uint32_t from = graph.id(q.a);
+            uint32_t to = graph.id(q.b);
+            bool resposta = q.a == q.b || (from != Graph::NONE && to != Graph::NONE && componente[from] == componente[to]);
+            cout << (resposta ? "true" : "false") << " " << q.a << " " << q.b << '\n';
+        }
+        return 0;
+    }
+
+    if(usar_indice){
+        indice.reset(new ReachIndex(graph));
+    }else if(threads > 0){
+        paralela.reset(new ParallelBfs(graph, threads));
+    }
+
+    for(const loader::Query& q : consultas){
+        cout << (has_relacion(q.a, q.b) ? "true" : "false") << " " << q.a << " " << q.b << '\n';
+    }
+}